@@ -8,9 +8,15 @@
 
 #include <Wire.h>
 #include <DS3231.h>
+#include <DS3231Format.h>
+
+// Format compiled at build time, unknown letters fail to compile
+typedef DS3231_FORMAT("Y-m-d\\TH:i:s") IsoFormat;
 
 DS3231 clock;
 RTCDateTime dt;
+char buffer[20];
+char isoBuffer[IsoFormat::size];
 
 void setup()
 {
@@ -54,6 +60,25 @@ void loop()
   Serial.print("Unixtime:                    ");
   Serial.println(clock.dateFormat("U", dt));
 
+  // Format into own buffer, returns number of written characters
+  size_t length = clock.dateFormat(buffer, sizeof(buffer), "Y-m-d H:i:s", dt);
+
+  Serial.print("Own buffer:                  ");
+  Serial.print(buffer);
+  Serial.print(" (");
+  Serial.print(length);
+  Serial.println(" chars)");
+
+  // Format straight to Serial, without any buffer
+  Serial.print("Streamed:                    ");
+  clock.dateFormat(Serial, "D, d M Y H:i:s", dt);
+  Serial.println();
+
+  // Compiled format, buffer sized exactly at build time
+  IsoFormat::format(isoBuffer, dt);
+  Serial.print("Compiled:                    ");
+  Serial.println(isoBuffer);
+
   Serial.println();
 
   delay(1000);
@@ -0,0 +1,75 @@
+/*
+  DS3231: Real-Time Clock. Redundant clocks behind a TCA9548A
+  Read more: www.jarzebski.pl/arduino/komponenty/zegar-czasu-rzeczywistego-rtc-ds3231.html
+  GIT: https://github.com/jarzebski/Arduino-DS3231
+  Web: http://www.jarzebski.pl
+  (c) 2014 by Korneliusz Jarzebski
+*/
+
+#include <Wire.h>
+#include <DS3231.h>
+#include <DS3231Mux.h>
+#include <DS3231Fleet.h>
+
+// Three DS3231 on channels 0 to 2 of a TCA9548A at 0x70
+DS3231TwoWire wireBus(Wire);
+DS3231Mux mux(wireBus);
+DS3231MuxChannel channel0(mux, 0);
+DS3231MuxChannel channel1(mux, 1);
+DS3231MuxChannel channel2(mux, 2);
+
+DS3231 clock0;
+DS3231 clock1;
+DS3231 clock2;
+
+// Clocks within 1 second of the median agree
+DS3231Fleet fleet(1);
+
+void setup()
+{
+  Serial.begin(9600);
+
+  // Initialize DS3231
+  Serial.println("Initialize DS3231");;
+  Wire.begin();
+  clock0.begin(channel0);
+  clock1.begin(channel1);
+  clock2.begin(channel2);
+
+  fleet.add(clock0);
+  fleet.add(clock1);
+  fleet.add(clock2);
+}
+
+void loop()
+{
+  // One channel switch and one 7 byte read per clock
+  uint8_t responding = fleet.read();
+
+  Serial.print("Median: ");
+  Serial.print(clock0.dateFormat("Y-m-d H:i:s", fleet.getMedian()));
+  Serial.print(" (");
+  Serial.print(fleet.getAgreeing());
+  Serial.print(" of ");
+  Serial.print(responding);
+  Serial.print(" agree)");
+
+  if (!fleet.hasConsensus())
+  {
+    Serial.print(" NO CONSENSUS");
+  }
+
+  Serial.println();
+
+  for (uint8_t i = 0; i < fleet.getCount(); i++)
+  {
+    if (fleet.isResponding(i) && !fleet.isAgreeing(i))
+    {
+      Serial.print("  Clock ");
+      Serial.print(i);
+      Serial.println(" is off");
+    }
+  }
+
+  delay(1000);
+}
@@ -8,16 +8,30 @@
 
 #include <Wire.h>
 #include <DS3231.h>
+#include <DS3231Events.h>
 
 DS3231 clock;
 RTCDateTime dt;
-boolean isAlarm = false;
 int alarmLED = 4;
+unsigned long lastPrint = 0;
+
+// Queue for up to 4 pending interrupts
+uint32_t eventBuffer[4];
+DS3231Events events(clock, eventBuffer, 4);
 
 void alarmFunction()
 {
-  Serial.println("*** INT 0 ***");
-  isAlarm = true;
+  // Only timestamp the edge, I2C is not used in interrupt
+  events.handleInterrupt();
+}
+
+void alarm1Handler(uint32_t stamp)
+{
+  Serial.print("*** Alarm 1, handled after ");
+  Serial.print(micros() - stamp);
+  Serial.println(" us ***");
+
+  digitalWrite(alarmLED, !digitalRead(alarmLED));
 }
 
 void setup()
@@ -43,6 +57,9 @@ void setup()
   // setAlarm1(Date or Day, Hour, Minute, Second, Mode, Armed = true)
   clock.setAlarm1(0, 0, 0, 10, DS3231_MATCH_S);
 
+  // Called from events.process() with the interrupt timestamp
+  events.setHandler1(alarm1Handler);
+
   // Attach Interrput to Arduino Pin 2
   attachInterrupt(digitalPinToInterrupt(2), alarmFunction, FALLING);
 
@@ -52,16 +69,15 @@ void setup()
 
 void loop()
 {
-  dt = clock.getDateTime();
-  Serial.println(clock.dateFormat("d-m-Y H:i:s - l", dt));
-  
-  digitalWrite(alarmLED, isAlarm);
-  if (isAlarm)
+  // Reads and clears STATUS until no alarm flag is left (at least two reads
+  // per interrupt), then calls the handler
+  events.process();
+
+  if (millis() - lastPrint >= 1000)
   {
-    isAlarm = !isAlarm;
-    clock.clearAlarm1();
+    lastPrint = millis();
+    dt = clock.getDateTime();
+    Serial.println(clock.dateFormat("d-m-Y H:i:s - l", dt));
   }
-  
-  delay(1000);
 }
-
+
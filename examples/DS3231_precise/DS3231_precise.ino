@@ -0,0 +1,66 @@
+/*
+  DS3231: Real-Time Clock. Sub-second timestamps from the 1Hz SQW output
+  Read more: www.jarzebski.pl/arduino/komponenty/zegar-czasu-rzeczywistego-rtc-ds3231.html
+  GIT: https://github.com/jarzebski/Arduino-DS3231
+  Web: http://www.jarzebski.pl
+  (c) 2014 by Korneliusz Jarzebski
+*/
+
+#include <Wire.h>
+#include <DS3231.h>
+
+DS3231 clock;
+RTCPreciseTime pt;
+
+void sqwFunction()
+{
+  clock.handleSqw();
+}
+
+void setup()
+{
+  Serial.begin(9600);
+
+  // Initialize DS3231
+  Serial.println("Initialize DS3231");;
+  clock.begin();
+
+  // Select 1Hz on SQW. Alarm interrupts are not available in this mode.
+  clock.enablePreciseClock();
+
+  // Attach Interrput to Arduino Pin 2, seconds change on the falling edge
+  attachInterrupt(digitalPinToInterrupt(2), sqwFunction, FALLING);
+
+  // Set on the second boundary of a reference, e.g. a GPS time message
+  // whose PPS pulse was timestamped with micros()
+  // RTCPreciseTime reference = { 1397408400, 0 };
+  // uint32_t ppsMicros = micros();
+  //
+  // if (clock.setPreciseTime(reference, ppsMicros))
+  // {
+  //   Serial.print("Set, first edge off by ");
+  //   Serial.print(clock.getSetError());
+  //   Serial.println(" us");
+  // }
+}
+
+void loop()
+{
+  // No I2C traffic after the first call
+  pt = clock.now();
+
+  Serial.print(pt.unixtime);
+  Serial.print(".");
+  if (pt.micros < 100000) Serial.print("0");
+  if (pt.micros < 10000) Serial.print("0");
+  if (pt.micros < 1000) Serial.print("0");
+  if (pt.micros < 100) Serial.print("0");
+  if (pt.micros < 10) Serial.print("0");
+  Serial.print(pt.micros);
+
+  // Microseconds of the MCU clock per RTC second
+  Serial.print(" MCU second: ");
+  Serial.println(clock.getSqwPeriod());
+
+  delay(250);
+}
@@ -22,6 +22,16 @@ void setup()
 
   // Set sketch compiling time
   clock.setDateTime(__DATE__, __TIME__);
+
+  // Or from the compiling time worked out at build time, with the offset
+  // of the build machine from UTC in seconds (#include <DS3231BuildTime.h>)
+  // clock.setDateTime(DS3231_BUILD_TIME(3600));
+
+  // Or from an ISO-8601 string, malformed strings are rejected
+  // if (DS3231::parseIso8601("2014-04-13T19:21:00+02:00", dt))
+  // {
+  //   clock.setDateTime(dt);
+  // }
 }
 
 void loop()
@@ -24,11 +24,25 @@ void setup()
 void loop()
 {
   // The temperature registers are updated after every 64-second conversion.
-  // If you want force temperature conversion use forceConversion()
+  // If you want force temperature conversion use forceConversion(),
+  // or pollTemperature() from loop() to wait without blocking
   clock.forceConversion();
 
   Serial.print("Temperature: ");
   Serial.println(clock.readTemperature());
 
+  // Same value in 0.25 C steps, without floating point code
+  int16_t quarters = clock.readTemperatureQuarters();
+
+  Serial.print("Temperature (integer): ");
+  if (quarters < 0)
+  {
+    Serial.print("-");
+    quarters = -quarters;
+  }
+  Serial.print(quarters / 4);
+  Serial.print(".");
+  Serial.println((quarters % 4) * 25);
+
   delay(1000);
 }
@@ -0,0 +1,73 @@
+/*
+  DS3231: Real-Time Clock. Many software timers on a single alarm
+  Read more: www.jarzebski.pl/arduino/komponenty/zegar-czasu-rzeczywistego-rtc-ds3231.html
+  GIT: https://github.com/jarzebski/Arduino-DS3231
+  Web: http://www.jarzebski.pl
+  (c) 2014 by Korneliusz Jarzebski
+*/
+
+#include <Wire.h>
+#include <DS3231.h>
+#include <DS3231Timers.h>
+
+DS3231 clock;
+
+DS3231Timer *heap[4];
+DS3231Timers timers(clock, heap, 4);
+
+void sample(void *context)
+{
+  Serial.println("Sample sensors");
+}
+
+void uplink(void *context)
+{
+  Serial.println("Send uplink");
+}
+
+void once(void *context)
+{
+  Serial.println("One-shot timer");
+}
+
+DS3231Timer sampleTimer(sample);
+DS3231Timer uplinkTimer(uplink);
+DS3231Timer onceTimer(once);
+
+void alarmFunction()
+{
+  timers.handleInterrupt();
+}
+
+void setup()
+{
+  Serial.begin(9600);
+
+  // Initialize DS3231
+  Serial.println("Initialize DS3231");;
+  clock.begin();
+
+  // INT/SQW pin as alarm interrupt output
+  clock.enableOutput(false);
+  clock.armAlarm1(false);
+  clock.clearAlarm1();
+
+  uint32_t now = clock.readDateTime().unixtime;
+
+  // start(timer, first deadline, period in seconds)
+  timers.start(sampleTimer, now + 10, 10);
+  timers.start(uplinkTimer, now + 60, 60);
+  timers.start(onceTimer, now + 25);
+
+  // Attach Interrput to Arduino Pin 2
+  attachInterrupt(digitalPinToInterrupt(2), alarmFunction, FALLING);
+}
+
+void loop()
+{
+  // Talk to the DS3231 outside of the interrupt
+  if (timers.isPending())
+  {
+    timers.dispatch();
+  }
+}
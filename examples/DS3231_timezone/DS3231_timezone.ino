@@ -0,0 +1,62 @@
+/*
+  DS3231: Real-Time Clock. Timezone example
+  Read more: www.jarzebski.pl/arduino/komponenty/zegar-czasu-rzeczywistego-rtc-ds3231.html
+  GIT: https://github.com/jarzebski/Arduino-DS3231
+  Web: http://www.jarzebski.pl
+  (c) 2014 by Korneliusz Jarzebski
+*/
+
+#include <Wire.h>
+#include <DS3231.h>
+#include <DS3231Timezone.h>
+
+DS3231 clock;
+RTCDateTime utc;
+RTCDateTime local;
+
+// Central Europe: UTC+1, daylight time from the last Sunday of March 02:00
+// to the last Sunday of October 03:00
+DS3231Timezone europe("CET-1CEST,M3.5.0,M10.5.0/3");
+
+// New York, US rules by default
+DS3231Timezone newYork("EST5EDT");
+
+void setup()
+{
+  Serial.begin(9600);
+
+  // Initialize DS3231
+  Serial.println("Initialize DS3231");;
+  clock.begin();
+
+  // The clock keeps UTC, e.g. from UNIX timestamp
+  // clock.setDateTime(1711846790);
+
+  // Manual UTC (Year, Month, Day, Hour, Minute, Second)
+  clock.setDateTime(2024, 3, 31, 0, 59, 50);
+}
+
+void loop()
+{
+  utc = clock.getDateTime();
+
+  Serial.print("UTC:      ");
+  Serial.println(clock.dateFormat("Y-m-d H:i:s", utc));
+
+  // Rules are only evaluated when a transition has passed
+  local = europe.toLocal(utc);
+
+  Serial.print("Europe:   ");
+  Serial.print(clock.dateFormat("Y-m-d H:i:s ", local));
+  Serial.println(europe.getAbbreviation(utc.unixtime));
+
+  local = newYork.toLocal(utc);
+
+  Serial.print("New York: ");
+  Serial.print(clock.dateFormat("Y-m-d H:i:s ", local));
+  Serial.println(newYork.getAbbreviation(utc.unixtime));
+
+  Serial.println();
+
+  delay(1000);
+}
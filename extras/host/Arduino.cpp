@@ -0,0 +1,296 @@
+/*
+
+The MIT License
+
+Copyright (c) 2014-2023 Korneliusz Jarzębski
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+
+#include <time.h>
+
+#include "Arduino.h"
+
+uint64_t HostClock::stepped = 0;
+uint64_t HostClock::pinnedAt = 0;
+bool HostClock::pinned = false;
+double HostClock::scale = 0.0;
+uint64_t HostClock::realStart = 0;
+bool HostClock::running = false;
+
+static void (*clockHooks[HOST_CLOCK_HOOKS])(void *context);
+static void *clockContexts[HOST_CLOCK_HOOKS];
+
+static void (*isrs[HOST_INTERRUPTS])(void);
+static int isrModes[HOST_INTERRUPTS];
+static uint8_t isrPending;
+static bool isrEnabled = true;
+static bool isrRunning = false;
+
+static uint64_t realMicros(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+uint64_t HostClock::now(void)
+{
+    if (pinned)
+    {
+        return pinnedAt;
+    }
+
+    if (running)
+    {
+        return stepped + (uint64_t)((realMicros() - realStart) * scale);
+    }
+
+    return stepped;
+}
+
+void HostClock::advance(uint64_t us)
+{
+    if (pinned)
+    {
+        return;
+    }
+
+    stepped += us;
+
+    for (uint8_t i = 0; i < HOST_CLOCK_HOOKS; i++)
+    {
+        if (clockHooks[i])
+        {
+            clockHooks[i](clockContexts[i]);
+        }
+    }
+}
+
+void HostClock::setScale(double scale)
+{
+    // Fold the time elapsed at the old scale into the stepped part
+    stepped = now();
+
+    HostClock::scale = scale;
+    realStart = realMicros();
+    running = (scale > 0.0);
+}
+
+double HostClock::getScale(void)
+{
+    return scale;
+}
+
+void HostClock::attach(void (*hook)(void *context), void *context)
+{
+    for (uint8_t i = 0; i < HOST_CLOCK_HOOKS; i++)
+    {
+        if (!clockHooks[i])
+        {
+            clockHooks[i] = hook;
+            clockContexts[i] = context;
+            return;
+        }
+    }
+}
+
+void HostClock::detach(void *context)
+{
+    for (uint8_t i = 0; i < HOST_CLOCK_HOOKS; i++)
+    {
+        if (clockContexts[i] == context)
+        {
+            clockHooks[i] = 0;
+            clockContexts[i] = 0;
+        }
+    }
+}
+
+void HostClock::pin(uint64_t us)
+{
+    pinnedAt = us;
+    pinned = true;
+}
+
+void HostClock::unpin(void)
+{
+    pinned = false;
+}
+
+bool HostClock::isPinned(void)
+{
+    return pinned;
+}
+
+// Reading the clock costs a microsecond, so loops that wait on millis()
+// or micros() terminate even when nothing else advances the clock.
+unsigned long millis(void)
+{
+    HostClock::advance(1);
+
+    return (unsigned long)(HostClock::now() / 1000);
+}
+
+unsigned long micros(void)
+{
+    HostClock::advance(1);
+
+    return (unsigned long)HostClock::now();
+}
+
+void delay(unsigned long ms)
+{
+    // Step in 1 ms slices so devices hooked to the clock see every edge on time
+    while (ms--)
+    {
+        HostClock::advance(1000);
+    }
+}
+
+void delayMicroseconds(unsigned int us)
+{
+    HostClock::advance(us);
+}
+
+static void runPending(void)
+{
+    if (isrRunning)
+    {
+        return;
+    }
+
+    isrRunning = true;
+
+    while (isrEnabled && isrPending)
+    {
+        for (uint8_t i = 0; i < HOST_INTERRUPTS; i++)
+        {
+            if (isrPending & (1 << i))
+            {
+                isrPending &= ~(1 << i);
+
+                if (isrs[i])
+                {
+                    isrs[i]();
+                }
+            }
+        }
+    }
+
+    isrRunning = false;
+}
+
+void noInterrupts(void)
+{
+    isrEnabled = false;
+}
+
+void interrupts(void)
+{
+    isrEnabled = true;
+
+    runPending();
+}
+
+void attachInterrupt(uint8_t interrupt, void (*isr)(void), int mode)
+{
+    if (interrupt < HOST_INTERRUPTS)
+    {
+        isrs[interrupt] = isr;
+        isrModes[interrupt] = mode;
+    }
+}
+
+void detachInterrupt(uint8_t interrupt)
+{
+    if (interrupt < HOST_INTERRUPTS)
+    {
+        isrs[interrupt] = 0;
+    }
+}
+
+void hostInterrupt(uint8_t interrupt, int edge)
+{
+    if ((interrupt >= HOST_INTERRUPTS) || !isrs[interrupt])
+    {
+        return;
+    }
+
+    if ((isrModes[interrupt] != CHANGE) && (isrModes[interrupt] != edge))
+    {
+        return;
+    }
+
+    isrPending |= (1 << interrupt);
+
+    runPending();
+}
+
+size_t Print::write(const uint8_t *buffer, size_t size)
+{
+    size_t n = 0;
+
+    while (size--)
+    {
+        n += write(*buffer++);
+    }
+
+    return n;
+}
+
+size_t Print::write(const char *str)
+{
+    return write((const uint8_t *)str, strlen(str));
+}
+
+size_t Print::print(const char *str)
+{
+    return write(str);
+}
+
+size_t Print::print(char c)
+{
+    return write((uint8_t)c);
+}
+
+size_t Print::print(unsigned long n)
+{
+    char buffer[11];
+
+    snprintf(buffer, sizeof(buffer), "%lu", n);
+
+    return write(buffer);
+}
+
+size_t Print::println(void)
+{
+    return write("\r\n");
+}
+
+size_t Print::println(const char *str)
+{
+    size_t n = write(str);
+
+    return n + println();
+}
@@ -0,0 +1,121 @@
+/*
+
+The MIT License
+
+Copyright (c) 2014-2023 Korneliusz Jarzębski
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+
+/*
+
+Minimal Arduino core for building the library on a desktop host.
+
+Only what the library and its simulator need is provided. Time is virtual:
+micros() returns HostClock::now(), which is advanced explicitly by advance()
+and delay(), by modelled I2C transfers, by one microsecond per millis() or
+micros() call and, when a time scale is set, by the real elapsed time
+multiplied by that scale.
+
+Build with -DARDUINO=100 and this directory on the include path.
+
+*/
+
+#ifndef Arduino_h
+#define Arduino_h
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#define PROGMEM
+#define pgm_read_byte(addr)         (*(const uint8_t *)(addr))
+#define pgm_read_word(addr)         (*(const uint16_t *)(addr))
+
+#define LOW                         (0x0)
+#define HIGH                        (0x1)
+
+#define CHANGE                      (1)
+#define FALLING                     (2)
+#define RISING                      (3)
+
+#define HOST_INTERRUPTS             (8)
+#define HOST_CLOCK_HOOKS            (8)
+
+#define digitalPinToInterrupt(p)    ((p) < HOST_INTERRUPTS ? (p) : -1)
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+class HostClock
+{
+    public:
+
+	static uint64_t now(void);
+	static void advance(uint64_t us);
+	static void setScale(double scale);
+	static double getScale(void);
+
+	static void attach(void (*hook)(void *context), void *context);
+	static void detach(void *context);
+
+	static void pin(uint64_t us);
+	static void unpin(void);
+	static bool isPinned(void);
+
+    private:
+	static uint64_t stepped;
+	static uint64_t pinnedAt;
+	static bool pinned;
+	static double scale;
+	static uint64_t realStart;
+	static bool running;
+};
+
+class Print
+{
+    public:
+
+	virtual size_t write(uint8_t c) = 0;
+	virtual size_t write(const uint8_t *buffer, size_t size);
+
+	size_t write(const char *str);
+	size_t print(const char *str);
+	size_t print(char c);
+	size_t print(unsigned long n);
+	size_t println(void);
+	size_t println(const char *str);
+};
+
+unsigned long millis(void);
+unsigned long micros(void);
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+void noInterrupts(void);
+void interrupts(void);
+void attachInterrupt(uint8_t interrupt, void (*isr)(void), int mode);
+void detachInterrupt(uint8_t interrupt);
+void hostInterrupt(uint8_t interrupt, int edge);
+
+#endif
@@ -0,0 +1,171 @@
+/*
+
+The MIT License
+
+Copyright (c) 2014-2023 Korneliusz Jarzębski
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+
+#include "Wire.h"
+
+TwoWire::TwoWire(void)
+{
+    for (uint8_t i = 0; i < HOST_WIRE_DEVICES; i++)
+    {
+        devices[i] = 0;
+    }
+
+    txLength = 0;
+    rxLength = 0;
+    rxIndex = 0;
+}
+
+void TwoWire::begin(void)
+{
+}
+
+void TwoWire::setClock(uint32_t)
+{
+}
+
+void TwoWire::attach(uint8_t address, HostWireDevice &device)
+{
+    for (uint8_t i = 0; i < HOST_WIRE_DEVICES; i++)
+    {
+        if (!devices[i] || (addresses[i] == address))
+        {
+            addresses[i] = address;
+            devices[i] = &device;
+            return;
+        }
+    }
+}
+
+void TwoWire::detach(uint8_t address)
+{
+    for (uint8_t i = 0; i < HOST_WIRE_DEVICES; i++)
+    {
+        if (devices[i] && (addresses[i] == address))
+        {
+            devices[i] = 0;
+        }
+    }
+}
+
+HostWireDevice *TwoWire::find(uint8_t address)
+{
+    for (uint8_t i = 0; i < HOST_WIRE_DEVICES; i++)
+    {
+        if (devices[i] && (addresses[i] == address))
+        {
+            return devices[i];
+        }
+    }
+
+    return 0;
+}
+
+void TwoWire::beginTransmission(uint8_t address)
+{
+    txAddress = address;
+    txLength = 0;
+}
+
+uint8_t TwoWire::endTransmission(bool)
+{
+    HostWireDevice *device = find(txAddress);
+
+    if (!device)
+    {
+        return 2;
+    }
+
+    if (!device->i2cWrite(txBuffer, txLength))
+    {
+        return 3;
+    }
+
+    return 0;
+}
+
+uint8_t TwoWire::requestFrom(uint8_t address, uint8_t quantity, bool)
+{
+    HostWireDevice *device = find(address);
+
+    rxLength = 0;
+    rxIndex = 0;
+
+    if (quantity > BUFFER_LENGTH)
+    {
+        quantity = BUFFER_LENGTH;
+    }
+
+    if (!device || !device->i2cRead(rxBuffer, quantity))
+    {
+        return 0;
+    }
+
+    rxLength = quantity;
+
+    return rxLength;
+}
+
+size_t TwoWire::write(uint8_t value)
+{
+    if (txLength >= BUFFER_LENGTH)
+    {
+        return 0;
+    }
+
+    txBuffer[txLength++] = value;
+
+    return 1;
+}
+
+size_t TwoWire::write(const uint8_t *values, size_t count)
+{
+    size_t written = 0;
+
+    while ((written < count) && write(values[written]))
+    {
+        written++;
+    }
+
+    return written;
+}
+
+int TwoWire::available(void)
+{
+    return rxLength - rxIndex;
+}
+
+int TwoWire::read(void)
+{
+    if (rxIndex >= rxLength)
+    {
+        return -1;
+    }
+
+    return rxBuffer[rxIndex++];
+}
+
+TwoWire Wire;
@@ -0,0 +1,89 @@
+/*
+
+The MIT License
+
+Copyright (c) 2014-2023 Korneliusz Jarzębski
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+
+/*
+
+Host stand-in for the Arduino Wire library. Transfers are routed by address
+to HostWireDevice objects attached to the bus; a transfer to an address
+with no device is not acknowledged.
+
+*/
+
+#ifndef TwoWire_h
+#define TwoWire_h
+
+#include "Arduino.h"
+
+#define BUFFER_LENGTH               (32)
+#define HOST_WIRE_DEVICES           (16)
+
+class HostWireDevice
+{
+    public:
+
+	virtual bool i2cWrite(const uint8_t *values, uint8_t count) = 0;
+	virtual bool i2cRead(uint8_t *values, uint8_t count) = 0;
+};
+
+class TwoWire
+{
+    public:
+
+	TwoWire(void);
+
+	void begin(void);
+	void setClock(uint32_t clock);
+
+	void attach(uint8_t address, HostWireDevice &device);
+	void detach(uint8_t address);
+
+	void beginTransmission(uint8_t address);
+	uint8_t endTransmission(bool stop = true);
+	uint8_t requestFrom(uint8_t address, uint8_t quantity, bool stop = true);
+
+	size_t write(uint8_t value);
+	size_t write(const uint8_t *values, size_t count);
+	int available(void);
+	int read(void);
+
+    private:
+	HostWireDevice *find(uint8_t address);
+
+	uint8_t addresses[HOST_WIRE_DEVICES];
+	HostWireDevice *devices[HOST_WIRE_DEVICES];
+
+	uint8_t txAddress;
+	uint8_t txBuffer[BUFFER_LENGTH];
+	uint8_t txLength;
+	uint8_t rxBuffer[BUFFER_LENGTH];
+	uint8_t rxLength;
+	uint8_t rxIndex;
+};
+
+extern TwoWire Wire;
+
+#endif
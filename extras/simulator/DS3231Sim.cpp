@@ -0,0 +1,548 @@
+/*
+
+The MIT License
+
+Copyright (c) 2014-2023 Korneliusz Jarzębski
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+
+#include "DS3231Sim.h"
+
+static const uint8_t simDaysArray[] = { 31,28,31,30,31,30,31,31,30,31,30,31 };
+
+DS3231Sim::DS3231Sim(uint8_t address)
+{
+    memset(regs, 0, sizeof(regs));
+
+    // Power-on state from the datasheet
+    regs[3] = 0x01;
+    regs[4] = 0x01;
+    regs[5] = 0x01;
+    regs[DS3231_REG_CONTROL] = 0b00011100;
+    regs[DS3231_REG_STATUS] = 0b10001000;
+
+    this->address = address;
+    pointer = 0;
+
+    last = HostClock::now();
+    phase = 0;
+    uptime = 0;
+
+    drift = 0;
+    trim = 0;
+    rest = 0;
+    second = 1000000;
+
+    converting = false;
+    conversionEnd = 0;
+    setTemperature(100);
+    finishConversion();
+
+    output = true;
+    interrupt = DS3231SIM_NOT_CONNECTED;
+    updating = false;
+
+    busClock = 100000;
+    resetCounters();
+
+    HostClock::attach(clockHook, this);
+}
+
+DS3231Sim::~DS3231Sim(void)
+{
+    HostClock::detach(this);
+}
+
+void DS3231Sim::clockHook(void *context)
+{
+    ((DS3231Sim *)context)->update();
+}
+
+bool DS3231Sim::readRegisters(uint8_t address, uint8_t reg, uint8_t *values, uint8_t count)
+{
+    if (address != this->address)
+    {
+        return false;
+    }
+
+    return i2cWrite(&reg, 1) && i2cRead(values, count);
+}
+
+bool DS3231Sim::writeRegisters(uint8_t address, uint8_t reg, const uint8_t *values, uint8_t count)
+{
+    uint8_t buffer[BUFFER_LENGTH];
+
+    if ((address != this->address) || (count >= BUFFER_LENGTH))
+    {
+        return false;
+    }
+
+    buffer[0] = reg;
+    memcpy(buffer + 1, values, count);
+
+    return i2cWrite(buffer, count + 1);
+}
+
+bool DS3231Sim::i2cWrite(const uint8_t *values, uint8_t count)
+{
+    update();
+
+    transactions++;
+
+    if (count == 0)
+    {
+        busDelay(1);
+        return true;
+    }
+
+    busDelay(2);
+    pointer = values[0] % DS3231_SNAPSHOT_SIZE;
+
+    // Each byte is latched when it is acknowledged, which matters for the seconds register
+    for (uint8_t i = 1; i < count; i++)
+    {
+        busDelay(1);
+        update();
+
+        store(pointer, values[i]);
+        pointer = (pointer + 1) % DS3231_SNAPSHOT_SIZE;
+    }
+
+    return true;
+}
+
+bool DS3231Sim::i2cRead(uint8_t *values, uint8_t count)
+{
+    uint8_t latched[DS3231_SNAPSHOT_SIZE];
+
+    update();
+
+    transactions++;
+
+    // The user buffers are copied on START, so a read never sees a tick half way
+    memcpy(latched, regs, sizeof(latched));
+
+    for (uint8_t i = 0; i < count; i++)
+    {
+        values[i] = latched[pointer];
+        pointer = (pointer + 1) % DS3231_SNAPSHOT_SIZE;
+    }
+
+    busDelay(1 + count);
+
+    return true;
+}
+
+void DS3231Sim::update(void)
+{
+    uint64_t now = HostClock::now();
+    bool pin = !HostClock::isPinned();
+
+    if (updating)
+    {
+        return;
+    }
+
+    updating = true;
+
+    while (last < now)
+    {
+        uint64_t step = now - last;
+
+        // Stop at every point where something observable happens
+        if ((phase < second / 2) && (step > second / 2 - phase))
+        {
+            step = second / 2 - phase;
+        }
+
+        if (step > second - phase)
+        {
+            step = second - phase;
+        }
+
+        if (converting && (step > conversionEnd - last))
+        {
+            step = conversionEnd - last;
+        }
+
+        last += step;
+        phase += step;
+
+        // Interrupt handlers see micros() of the edge, not of the caller
+        if (pin)
+        {
+            HostClock::pin(last);
+        }
+
+        if (converting && (last >= conversionEnd))
+        {
+            finishConversion();
+        }
+
+        if (phase >= second)
+        {
+            phase = 0;
+            tick();
+            nextSecond();
+        }
+
+        updateOutput();
+
+        if (pin)
+        {
+            HostClock::unpin();
+        }
+    }
+
+    updating = false;
+}
+
+void DS3231Sim::tick(void)
+{
+    uint8_t second = bcd2dec(regs[0] & 0b01111111);
+    uint8_t minute = bcd2dec(regs[1] & 0b01111111);
+    uint8_t hour;
+    uint8_t dow = regs[3] & 0b00000111;
+    uint8_t day = bcd2dec(regs[4] & 0b00111111);
+    uint8_t month = bcd2dec(regs[5] & 0b00011111);
+    uint8_t century = regs[5] & 0b10000000;
+    uint8_t year = bcd2dec(regs[6]);
+    bool mode12 = regs[2] & 0b01000000;
+
+    if (mode12)
+    {
+        hour = bcd2dec(regs[2] & 0b00011111) % 12;
+
+        if (regs[2] & 0b00100000)
+        {
+            hour += 12;
+        }
+    } else
+    {
+        hour = bcd2dec(regs[2] & 0b00111111);
+    }
+
+    if (++second >= 60)
+    {
+        second = 0;
+
+        if (++minute >= 60)
+        {
+            minute = 0;
+
+            if (++hour >= 24)
+            {
+                uint8_t days = 31;
+
+                hour = 0;
+                dow = (dow % 7) + 1;
+
+                // The chip only looks at the two digit year, so 2100 counts as a leap year
+                if ((month >= 1) && (month <= 12))
+                {
+                    days = simDaysArray[month - 1];
+
+                    if ((month == 2) && (year % 4 == 0))
+                    {
+                        ++days;
+                    }
+                }
+
+                if (++day > days)
+                {
+                    day = 1;
+
+                    if (++month > 12)
+                    {
+                        month = 1;
+
+                        if (++year >= 100)
+                        {
+                            year = 0;
+                            century ^= 0b10000000;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    regs[0] = dec2bcd(second);
+    regs[1] = dec2bcd(minute);
+    regs[3] = dow;
+    regs[4] = dec2bcd(day);
+    regs[5] = century | dec2bcd(month);
+    regs[6] = dec2bcd(year);
+
+    if (mode12)
+    {
+        uint8_t hour12 = hour % 12;
+
+        regs[2] = 0b01000000 | (hour >= 12 ? 0b00100000 : 0) | dec2bcd(hour12 ? hour12 : 12);
+    } else
+    {
+        regs[2] = dec2bcd(hour);
+    }
+
+    checkAlarms();
+
+    if ((++uptime % 64) == 0)
+    {
+        startConversion();
+    }
+}
+
+void DS3231Sim::checkAlarms(void)
+{
+    const uint8_t *a1 = regs + DS3231_REG_ALARM_1;
+    const uint8_t *a2 = regs + DS3231_REG_ALARM_2;
+    bool day1;
+    bool day2;
+
+    if (a1[3] & 0b01000000)
+    {
+        day1 = ((a1[3] & 0b00001111) == regs[3]);
+    } else
+    {
+        day1 = ((a1[3] & 0b00111111) == regs[4]);
+    }
+
+    if (a2[2] & 0b01000000)
+    {
+        day2 = ((a2[2] & 0b00001111) == regs[3]);
+    } else
+    {
+        day2 = ((a2[2] & 0b00111111) == regs[4]);
+    }
+
+    if (((a1[0] & 0b10000000) || ((a1[0] & 0b01111111) == regs[0])) &&
+        ((a1[1] & 0b10000000) || ((a1[1] & 0b01111111) == regs[1])) &&
+        ((a1[2] & 0b10000000) || ((a1[2] & 0b01111111) == regs[2])) &&
+        ((a1[3] & 0b10000000) || day1))
+    {
+        regs[DS3231_REG_STATUS] |= 0b00000001;
+    }
+
+    // Alarm 2 has no seconds register and fires at 00 seconds
+    if ((regs[0] == 0) &&
+        ((a2[0] & 0b10000000) || ((a2[0] & 0b01111111) == regs[1])) &&
+        ((a2[1] & 0b10000000) || ((a2[1] & 0b01111111) == regs[2])) &&
+        ((a2[2] & 0b10000000) || day2))
+    {
+        regs[DS3231_REG_STATUS] |= 0b00000010;
+    }
+}
+
+void DS3231Sim::startConversion(void)
+{
+    if (converting)
+    {
+        return;
+    }
+
+    converting = true;
+    conversionEnd = last + DS3231SIM_CONVERSION_TIME;
+
+    regs[DS3231_REG_STATUS] |= 0b00000100;
+}
+
+void DS3231Sim::finishConversion(void)
+{
+    converting = false;
+
+    regs[DS3231_REG_CONTROL] &= 0b11011111;
+    regs[DS3231_REG_STATUS] &= 0b11111011;
+    regs[DS3231_REG_TEMPERATURE] = (uint8_t)(temperature >> 2);
+    regs[DS3231_REG_TEMPERATURE + 1] = (uint8_t)((temperature & 0b11) << 6);
+
+    // The aging offset is applied with each conversion
+    trim = (int8_t)regs[DS3231_REG_AGING];
+}
+
+// Length of the next second in host microseconds. The fractional part is
+// carried over, so any rate in ppb is followed exactly on average.
+void DS3231Sim::nextSecond(void)
+{
+    int64_t nanos = 1000000000LL * 1000000000LL / (1000000000LL + drift - trim * 100LL) + rest;
+
+    second = (uint32_t)(nanos / 1000);
+    rest = nanos % 1000;
+}
+
+void DS3231Sim::updateOutput(void)
+{
+    uint8_t control = regs[DS3231_REG_CONTROL];
+    bool level;
+
+    if (control & 0b00000100)
+    {
+        // INTCN: active low while an enabled alarm flag is set
+        level = !(regs[DS3231_REG_STATUS] & control & 0b00000011);
+    } else if ((control & 0b00011000) == 0)
+    {
+        // 1Hz: the falling edge is the seconds update
+        level = (phase >= second / 2);
+    } else
+    {
+        // Faster square waves are not modelled
+        level = true;
+    }
+
+    if (level == output)
+    {
+        return;
+    }
+
+    output = level;
+
+    if (interrupt != DS3231SIM_NOT_CONNECTED)
+    {
+        hostInterrupt(interrupt, level ? RISING : FALLING);
+    }
+}
+
+void DS3231Sim::store(uint8_t reg, uint8_t value)
+{
+    switch (reg)
+    {
+        case DS3231_REG_TIME:
+            // Writing seconds resets the countdown chain
+            regs[reg] = value & 0b01111111;
+            phase = 0;
+            break;
+
+        case DS3231_REG_CONTROL:
+            // CONV can only be set, the chip clears it
+            regs[reg] = value | (regs[reg] & 0b00100000);
+
+            if (value & 0b00100000)
+            {
+                startConversion();
+            }
+            break;
+
+        case DS3231_REG_STATUS:
+            // OSF, A2F and A1F can only be cleared, BSY is read only
+            regs[reg] = (regs[reg] & value & 0b10000011) | (value & 0b00001000) | (regs[reg] & 0b00000100);
+            break;
+
+        case DS3231_REG_TEMPERATURE:
+        case DS3231_REG_TEMPERATURE + 1:
+            break;
+
+        default:
+            regs[reg] = value;
+            break;
+    }
+
+    updateOutput();
+}
+
+void DS3231Sim::busDelay(uint8_t bytes)
+{
+    // Nine clocks per byte including ACK
+    uint64_t us = ((uint64_t)bytes * 9000000 + busClock / 2) / busClock;
+
+    this->bytes += bytes;
+    busTime += us;
+
+    HostClock::advance(us);
+}
+
+void DS3231Sim::setBusClock(uint32_t clock)
+{
+    busClock = clock;
+}
+
+void DS3231Sim::setInterruptPin(uint8_t interrupt)
+{
+    this->interrupt = interrupt;
+}
+
+bool DS3231Sim::readInterruptPin(void)
+{
+    update();
+
+    return output;
+}
+
+// Crystal error in ppb, positive runs fast. Each aging LSB slows the
+// oscillator by 0.1 ppm from the next conversion on.
+void DS3231Sim::setDrift(int32_t ppb)
+{
+    update();
+
+    drift = ppb;
+}
+
+void DS3231Sim::setTemperature(int16_t quarters)
+{
+    temperature = quarters;
+}
+
+uint8_t DS3231Sim::peek(uint8_t reg)
+{
+    update();
+
+    return regs[reg % DS3231_SNAPSHOT_SIZE];
+}
+
+void DS3231Sim::poke(uint8_t reg, uint8_t value)
+{
+    update();
+
+    regs[reg % DS3231_SNAPSHOT_SIZE] = value;
+
+    updateOutput();
+}
+
+uint32_t DS3231Sim::getTransactions(void)
+{
+    return transactions;
+}
+
+uint32_t DS3231Sim::getBytes(void)
+{
+    return bytes;
+}
+
+uint64_t DS3231Sim::getBusTime(void)
+{
+    return busTime;
+}
+
+void DS3231Sim::resetCounters(void)
+{
+    transactions = 0;
+    bytes = 0;
+    busTime = 0;
+}
+
+uint8_t DS3231Sim::bcd2dec(uint8_t bcd)
+{
+    return ((bcd / 16) * 10) + (bcd % 16);
+}
+
+uint8_t DS3231Sim::dec2bcd(uint8_t dec)
+{
+    return ((dec / 10) * 16) + (dec % 10);
+}
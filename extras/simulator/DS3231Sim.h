@@ -0,0 +1,133 @@
+/*
+
+The MIT License
+
+Copyright (c) 2014-2023 Korneliusz Jarzębski
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+
+/*
+
+Register-level DS3231 simulator for desktop builds.
+
+The simulator keeps the full register file and lets it run on HostClock
+time: time-keeping registers tick (including the century bit), alarms set
+A1F/A2F, INT/SQW follows INTCN or produces the 1Hz square wave, and the
+temperature is converted every 64 seconds or on CONV with BSY raised for
+the conversion time. The oscillator runs off by setDrift() ppb, corrected
+by the aging offset as of the last conversion. Every transfer advances HostClock by its duration on
+the bus, so driver traffic can be measured.
+
+It can be used as a DS3231Bus with DS3231::begin(DS3231Bus &) or attached
+to the host Wire so that a plain DS3231::begin() talks to it. Time is
+accelerated with HostClock::advance() or HostClock::setScale().
+
+Build with -DARDUINO=100 -Iextras/host -Isrc, for example:
+
+    g++ -DARDUINO=100 -Iextras/host -Isrc -Iextras/simulator app.cpp \
+        src/DS3231.cpp extras/host/Arduino.cpp extras/host/Wire.cpp \
+        extras/simulator/DS3231Sim.cpp
+
+*/
+
+#ifndef DS3231Sim_h
+#define DS3231Sim_h
+
+#include "Arduino.h"
+#include "Wire.h"
+#include "DS3231.h"
+
+#define DS3231SIM_CONVERSION_TIME   (200000)
+#define DS3231SIM_NOT_CONNECTED     (0xFF)
+
+class DS3231Sim : public DS3231Bus, public HostWireDevice
+{
+    public:
+
+	DS3231Sim(uint8_t address = DS3231_ADDRESS);
+	~DS3231Sim(void);
+
+	virtual bool readRegisters(uint8_t address, uint8_t reg, uint8_t *values, uint8_t count);
+	virtual bool writeRegisters(uint8_t address, uint8_t reg, const uint8_t *values, uint8_t count);
+
+	virtual bool i2cWrite(const uint8_t *values, uint8_t count);
+	virtual bool i2cRead(uint8_t *values, uint8_t count);
+
+	void update(void);
+
+	void setBusClock(uint32_t clock);
+	void setInterruptPin(uint8_t interrupt);
+	bool readInterruptPin(void);
+	void setTemperature(int16_t quarters);
+	void setDrift(int32_t ppb);
+
+	uint8_t peek(uint8_t reg);
+	void poke(uint8_t reg, uint8_t value);
+
+	uint32_t getTransactions(void);
+	uint32_t getBytes(void);
+	uint64_t getBusTime(void);
+	void resetCounters(void);
+
+    private:
+	static void clockHook(void *context);
+
+	void tick(void);
+	void checkAlarms(void);
+	void startConversion(void);
+	void finishConversion(void);
+	void nextSecond(void);
+	void updateOutput(void);
+	void store(uint8_t reg, uint8_t value);
+	void busDelay(uint8_t bytes);
+
+	static uint8_t bcd2dec(uint8_t bcd);
+	static uint8_t dec2bcd(uint8_t dec);
+
+	uint8_t regs[DS3231_SNAPSHOT_SIZE];
+	uint8_t address;
+	uint8_t pointer;
+
+	uint64_t last;
+	uint32_t phase;
+	uint32_t uptime;
+
+	int32_t drift;
+	int8_t trim;
+	int32_t rest;
+	uint32_t second;
+
+	bool converting;
+	uint64_t conversionEnd;
+	int16_t temperature;
+
+	bool output;
+	uint8_t interrupt;
+	bool updating;
+
+	uint32_t busClock;
+	uint32_t transactions;
+	uint32_t bytes;
+	uint64_t busTime;
+};
+
+#endif
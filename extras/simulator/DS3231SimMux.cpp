@@ -0,0 +1,134 @@
+/*
+
+The MIT License
+
+Copyright (c) 2014-2023 Korneliusz Jarzębski
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "DS3231SimMux.h"
+
+DS3231SimMux::DS3231SimMux(uint8_t address)
+{
+    this->address = address;
+    mask = 0;
+
+    for (uint8_t i = 0; i < DS3231SIMMUX_CHANNELS; i++)
+    {
+        channels[i] = 0;
+    }
+
+    busClock = 100000;
+    resetCounters();
+}
+
+void DS3231SimMux::attach(uint8_t channel, DS3231Bus &bus)
+{
+    channels[channel] = &bus;
+}
+
+void DS3231SimMux::detach(uint8_t channel)
+{
+    channels[channel] = 0;
+}
+
+bool DS3231SimMux::readRegisters(uint8_t address, uint8_t reg, uint8_t *values, uint8_t count)
+{
+    uint8_t channel = DS3231SIMMUX_CHANNELS;
+
+    if (address == this->address)
+    {
+        values[0] = mask;
+        return (count == 1);
+    }
+
+    for (uint8_t i = 0; i < DS3231SIMMUX_CHANNELS; i++)
+    {
+        if ((mask & (1 << i)) && channels[i])
+        {
+            // Two devices driving SDA at once
+            if (channel != DS3231SIMMUX_CHANNELS)
+            {
+                return false;
+            }
+
+            channel = i;
+        }
+    }
+
+    if (channel == DS3231SIMMUX_CHANNELS)
+    {
+        return false;
+    }
+
+    return channels[channel]->readRegisters(address, reg, values, count);
+}
+
+bool DS3231SimMux::writeRegisters(uint8_t address, uint8_t reg, const uint8_t *values, uint8_t count)
+{
+    bool acknowledged = false;
+
+    if (address == this->address)
+    {
+        if (count != 0)
+        {
+            return false;
+        }
+
+        // Address and control byte, nine clocks each
+        HostClock::advance((18000000 + busClock / 2) / busClock);
+
+        mask = reg;
+        selects++;
+
+        return true;
+    }
+
+    for (uint8_t i = 0; i < DS3231SIMMUX_CHANNELS; i++)
+    {
+        if ((mask & (1 << i)) && channels[i])
+        {
+            acknowledged |= channels[i]->writeRegisters(address, reg, values, count);
+        }
+    }
+
+    return acknowledged;
+}
+
+uint8_t DS3231SimMux::getMask(void)
+{
+    return mask;
+}
+
+void DS3231SimMux::setBusClock(uint32_t clock)
+{
+    busClock = clock;
+}
+
+uint32_t DS3231SimMux::getSelects(void)
+{
+    return selects;
+}
+
+void DS3231SimMux::resetCounters(void)
+{
+    selects = 0;
+}
@@ -0,0 +1,79 @@
+/*
+
+The MIT License
+
+Copyright (c) 2014-2023 Korneliusz Jarzębski
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+/*
+
+TCA9548A I2C multiplexer stand-in for desktop builds.
+
+A DS3231Bus that answers its own address with the channel mask and passes
+every other transfer to the bus attached on the enabled channels, usually a
+DS3231Sim each. Writes go to all enabled channels; a read with more than one
+channel enabled is a bus conflict and fails, as does any transfer with none
+enabled. Selecting costs the two bytes of the control write on HostClock.
+
+    DS3231SimMux mux;
+    DS3231Sim sim0, sim1;
+
+    mux.attach(0, sim0);
+    mux.attach(1, sim1);
+
+*/
+
+#ifndef DS3231SimMux_h
+#define DS3231SimMux_h
+
+#include "Arduino.h"
+#include "DS3231.h"
+
+#define DS3231SIMMUX_CHANNELS       (8)
+
+class DS3231SimMux : public DS3231Bus
+{
+    public:
+
+	DS3231SimMux(uint8_t address = 0x70);
+
+	void attach(uint8_t channel, DS3231Bus &bus);
+	void detach(uint8_t channel);
+
+	virtual bool readRegisters(uint8_t address, uint8_t reg, uint8_t *values, uint8_t count);
+	virtual bool writeRegisters(uint8_t address, uint8_t reg, const uint8_t *values, uint8_t count);
+
+	uint8_t getMask(void);
+	void setBusClock(uint32_t clock);
+	uint32_t getSelects(void);
+	void resetCounters(void);
+
+    private:
+	uint8_t address;
+	uint8_t mask;
+	DS3231Bus *channels[DS3231SIMMUX_CHANNELS];
+
+	uint32_t busClock;
+	uint32_t selects;
+};
+
+#endif
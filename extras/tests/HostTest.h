@@ -0,0 +1,73 @@
+/*
+
+The MIT License
+
+Copyright (c) 2014-2023 Korneliusz Jarzębski
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+/*
+
+Minimal checks for the host tests. CHECK() counts a failure and prints its
+location without stopping the test; finish() prints the summary and gives
+the exit code for main().
+
+*/
+
+#ifndef HostTest_h
+#define HostTest_h
+
+#include <stdio.h>
+
+#define CHECK(condition) HostTest::check((condition), #condition, __FILE__, __LINE__)
+
+class HostTest
+{
+    public:
+
+	static bool check(bool passed, const char *condition, const char *file, int line)
+	{
+	    checks++;
+
+	    if (!passed && (failures++ < 20))
+	    {
+	        fprintf(stderr, "%s:%d: CHECK(%s) failed\n", file, line, condition);
+	    }
+
+	    return passed;
+	}
+
+	static int finish(const char *name)
+	{
+	    printf("%-20s %7lu checks, %lu failed\n", name, checks, failures);
+
+	    return failures ? 1 : 0;
+	}
+
+    private:
+	static unsigned long checks;
+	static unsigned long failures;
+};
+
+unsigned long HostTest::checks = 0;
+unsigned long HostTest::failures = 0;
+
+#endif
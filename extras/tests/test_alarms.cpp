@@ -0,0 +1,102 @@
+/*
+
+The MIT License
+
+Copyright (c) 2014-2023 Korneliusz Jarzębski
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+/*
+
+Alarm programming: the registers written, the number of bus transactions
+with and without the shadow cache, and the flags kept.
+
+*/
+
+#include "Arduino.h"
+#include "DS3231.h"
+#include "DS3231Sim.h"
+#include "HostTest.h"
+
+DS3231Sim sim;
+DS3231 rtc;
+
+static void checkProgramming(void)
+{
+    RTCAlarmTime alarm1 = { 0, 0, 0, 15 };
+    RTCAlarmTime alarm2 = { 3, 10, 2, 0 };
+
+    rtc.begin(sim);
+    rtc.setDateTime(2024, 5, 1, 10, 0, 0);
+
+    sim.poke(DS3231_REG_STATUS, sim.peek(DS3231_REG_STATUS) | 0b00000011);
+    sim.resetCounters();
+    rtc.setAlarm1(0, 0, 0, 30, DS3231_MATCH_S);
+    CHECK(sim.getTransactions() == 4);
+    CHECK((sim.peek(7) == 0x30) && (sim.peek(8) == 0x80) && (sim.peek(9) == 0x80) && (sim.peek(10) == 0x80));
+    CHECK(sim.peek(DS3231_REG_CONTROL) == 0x19);
+    CHECK(sim.peek(DS3231_REG_STATUS) == 0x8A);
+
+    // Both alarms in one burst, flags cleared and interrupts enabled together
+    sim.poke(DS3231_REG_STATUS, sim.peek(DS3231_REG_STATUS) | 0b00000011);
+    sim.resetCounters();
+    rtc.setAlarms(alarm1, DS3231_MATCH_S, alarm2, DS3231_MATCH_DY_H_M);
+    CHECK(sim.getTransactions() == 3);
+    CHECK(sim.peek(DS3231_REG_CONTROL) == 0x1B);
+    CHECK(sim.peek(DS3231_REG_STATUS) == 0x88);
+    CHECK(rtc.getAlarmType1() == DS3231_MATCH_S);
+    CHECK(rtc.getAlarmType2() == DS3231_MATCH_DY_H_M);
+    CHECK(rtc.getAlarm2().day == 3 && rtc.getAlarm2().hour == 10 && rtc.getAlarm2().minute == 2);
+    CHECK(rtc.isArmed1() && rtc.isArmed2());
+
+    // The shadow cache saves the CONTROL and STATUS reads
+    rtc.enableCache(true);
+    sim.resetCounters();
+    rtc.setAlarms(alarm1, DS3231_MATCH_S, alarm2, DS3231_MATCH_DY_H_M);
+    CHECK(sim.getTransactions() == 1);
+
+    sim.resetCounters();
+    rtc.setAlarm1(0, 0, 0, 30, DS3231_MATCH_S);
+    CHECK(sim.getTransactions() == 2);
+
+    // An OSF raised after the cached copy was taken is written back as 1
+    rtc.pollAlarms(DS3231_STOPPED);
+    sim.poke(DS3231_REG_STATUS, sim.peek(DS3231_REG_STATUS) | DS3231_STOPPED);
+    rtc.setAlarms(alarm1, DS3231_MATCH_S, alarm2, DS3231_MATCH_DY_H_M);
+    CHECK(sim.peek(DS3231_REG_STATUS) & DS3231_STOPPED);
+
+    rtc.pollAlarms(DS3231_STOPPED);
+    sim.poke(DS3231_REG_STATUS, sim.peek(DS3231_REG_STATUS) | DS3231_STOPPED);
+    rtc.setAlarm1(0, 0, 0, 30, DS3231_MATCH_S);
+    CHECK(sim.peek(DS3231_REG_STATUS) & DS3231_STOPPED);
+
+    delay(35000);
+    CHECK(rtc.isAlarm1(false));
+    CHECK(!rtc.isAlarm2(false));
+    rtc.enableCache(false);
+}
+
+int main(void)
+{
+    checkProgramming();
+
+    return HostTest::finish("test_alarms");
+}
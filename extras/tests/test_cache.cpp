@@ -0,0 +1,109 @@
+/*
+
+The MIT License
+
+Copyright (c) 2014-2023 Korneliusz Jarzębski
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+/*
+
+Shadow cache of CONTROL and STATUS: the register writes work from the
+cached copy and must not clear a flag the chip raised after it was taken.
+
+*/
+
+#include "Arduino.h"
+#include "DS3231.h"
+#include "DS3231Sim.h"
+#include "HostTest.h"
+
+DS3231Sim sim;
+DS3231 rtc;
+
+// Raises OSF behind the back of the cache
+static void stop(void)
+{
+    sim.poke(DS3231_REG_STATUS, sim.peek(DS3231_REG_STATUS) | DS3231_STOPPED);
+}
+
+static bool stopped(void)
+{
+    return sim.peek(DS3231_REG_STATUS) & DS3231_STOPPED;
+}
+
+static void checkStopped(void)
+{
+    rtc.begin(sim);
+    rtc.setDateTime(2024, 5, 1, 10, 0, 0);
+    rtc.pollAlarms(DS3231_STOPPED);
+    CHECK(!stopped());
+
+    rtc.enableCache(true);
+    CHECK(rtc.isCached());
+
+    stop();
+    sim.resetCounters();
+    rtc.enable32kHz(false);
+    CHECK(sim.getTransactions() == 1);
+    CHECK(stopped());
+    CHECK(!rtc.is32kHz() && !(sim.peek(DS3231_REG_STATUS) & 0b00001000));
+
+    rtc.pollAlarms(DS3231_STOPPED);
+    stop();
+    rtc.clearAlarm1();
+    CHECK(stopped());
+
+    rtc.pollAlarms(DS3231_STOPPED);
+    stop();
+    rtc.clearAlarm2();
+    CHECK(stopped());
+
+    // Only an explicit acknowledge clears it
+    CHECK(rtc.pollAlarms(DS3231_STOPPED) & DS3231_STOPPED);
+    CHECK(!stopped());
+
+    rtc.enableCache(false);
+}
+
+static void checkFlags(void)
+{
+    rtc.begin(sim);
+    rtc.setDateTime(2024, 5, 1, 10, 0, 0);
+    rtc.enableCache(true);
+
+    // A flag raised after the refresh is kept by the other clear
+    sim.poke(DS3231_REG_STATUS, sim.peek(DS3231_REG_STATUS) | 0b00000011);
+    rtc.clearAlarm1();
+    CHECK((sim.peek(DS3231_REG_STATUS) & 0b00000011) == 0b00000010);
+    rtc.clearAlarm2();
+    CHECK((sim.peek(DS3231_REG_STATUS) & 0b00000011) == 0);
+
+    rtc.enableCache(false);
+}
+
+int main(void)
+{
+    checkStopped();
+    checkFlags();
+
+    return HostTest::finish("test_cache");
+}
@@ -0,0 +1,212 @@
+/*
+
+The MIT License
+
+Copyright (c) 2014-2023 Korneliusz Jarzębski
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+/*
+
+Calendar kernel, century bit and date arithmetic against the C library.
+
+*/
+
+#include <time.h>
+#include <stdlib.h>
+
+#include "Arduino.h"
+#include "DS3231.h"
+#include "DS3231Sim.h"
+#include "HostTest.h"
+
+DS3231Sim sim;
+DS3231 rtc;
+
+static int64_t reference(const RTCDateTime &dt)
+{
+    struct tm t = tm();
+
+    t.tm_year = dt.year - 1900;
+    t.tm_mon = dt.month - 1;
+    t.tm_mday = dt.day;
+    t.tm_hour = dt.hour;
+    t.tm_min = dt.minute;
+    t.tm_sec = dt.second;
+
+    return (int64_t)timegm(&t) - 946684800 + DS3231_EPOCH;
+}
+
+static RTCDateTime make(uint16_t year, uint8_t month, uint8_t day, uint8_t hour, uint8_t minute, uint8_t second)
+{
+    RTCDateTime dt;
+
+    dt.year = year;
+    dt.month = month;
+    dt.day = day;
+    dt.hour = hour;
+    dt.minute = minute;
+    dt.second = second;
+
+    return DS3231::fromEpoch(DS3231::toEpoch(dt));
+}
+
+static void checkDays(void)
+{
+    // Every day from 2000 to 2199, at a time that moves through the day
+    for (int64_t t = DS3231_EPOCH; t < DS3231_EPOCH + 73049LL * 86400; t += 86400 + 3607)
+    {
+        RTCDateTime dt = DS3231::fromEpoch(t);
+        time_t seconds = (time_t)(t - DS3231_EPOCH + 946684800);
+        struct tm g;
+
+        gmtime_r(&seconds, &g);
+
+        CHECK((dt.year == g.tm_year + 1900) && (dt.month == g.tm_mon + 1) && (dt.day == g.tm_mday));
+        CHECK((dt.hour == g.tm_hour) && (dt.minute == g.tm_min) && (dt.second == g.tm_sec));
+        CHECK(dt.dayOfWeek == ((g.tm_wday == 0) ? 7 : g.tm_wday));
+        CHECK(DS3231::toEpoch(dt) == t);
+        CHECK(reference(dt) == t);
+        CHECK(dt.unixtime == (uint32_t)t);
+
+        // The 32-bit unixtime still decodes while the seconds since 2000 fit
+        if (t - DS3231_EPOCH < 0x100000000LL)
+        {
+            RTCDateTime wrapped = DS3231::loadDateTimeFromLong((uint32_t)t);
+
+            CHECK((wrapped.year == dt.year) && (wrapped.month == dt.month) && (wrapped.day == dt.day));
+        }
+    }
+}
+
+static void checkArithmetic(void)
+{
+    const int64_t last = DS3231_EPOCH + 73049LL * 86400;
+
+    srand(3);
+
+    for (int i = 0; i < 200000; i++)
+    {
+        int64_t t = DS3231_EPOCH + (int64_t)((uint64_t)rand() * rand() % (86400ULL * 365 * 190));
+        int32_t seconds = ((rand() % 2) ? 1 : -1) * (int32_t)((uint64_t)rand() * rand() % (86400ULL * 3000));
+        int32_t days = rand() % 20000 - 10000;
+        RTCDateTime dt = DS3231::fromEpoch(t);
+
+        if ((t + seconds >= DS3231_EPOCH) && (t + seconds < last))
+        {
+            RTCDateTime moved = DS3231::addSeconds(dt, seconds);
+            int8_t order = DS3231::compare(moved, dt);
+
+            CHECK(DS3231::toEpoch(moved) == t + seconds);
+            CHECK(DS3231::diff(moved, dt) == seconds);
+            CHECK((order > 0) == (seconds > 0));
+            CHECK((order == 0) == (seconds == 0));
+        } else
+        {
+            CHECK(DS3231::toEpoch(DS3231::addSeconds(dt, seconds)) == ((seconds < 0) ? DS3231_EPOCH : last - 1));
+        }
+
+        if ((t + (int64_t)days * 86400 >= DS3231_EPOCH) && (t + (int64_t)days * 86400 < last))
+        {
+            CHECK(DS3231::toEpoch(DS3231::addDays(dt, days)) == t + (int64_t)days * 86400);
+        } else
+        {
+            CHECK(DS3231::toEpoch(DS3231::addDays(dt, days)) == ((days < 0) ? DS3231_EPOCH : last - 1));
+        }
+    }
+
+    // Months clamp the day to the length of the target month
+    RTCDateTime dt = make(2024, 1, 31, 10, 0, 0);
+
+    CHECK(DS3231::toEpoch(DS3231::addMonths(dt, 1)) == DS3231::toEpoch(make(2024, 2, 29, 10, 0, 0)));
+    CHECK(DS3231::toEpoch(DS3231::addMonths(dt, 13)) == DS3231::toEpoch(make(2025, 2, 28, 10, 0, 0)));
+    CHECK(DS3231::toEpoch(DS3231::addMonths(dt, -25)) == DS3231::toEpoch(make(2021, 12, 31, 10, 0, 0)));
+    CHECK(DS3231::toEpoch(DS3231::addMonths(make(2100, 1, 31, 0, 0, 0), 1)) == DS3231::toEpoch(make(2100, 2, 28, 0, 0, 0)));
+    CHECK(DS3231::toEpoch(DS3231::addMonths(make(2199, 5, 31, 8, 0, 0), 32767)) == DS3231::toEpoch(make(2199, 12, 31, 8, 0, 0)));
+}
+
+static void checkSaturation(void)
+{
+    const int64_t first = DS3231_EPOCH;
+    const int64_t last = DS3231_EPOCH + 73049LL * 86400 - 1;
+    RTCDateTime start = make(2000, 1, 1, 0, 0, 5);
+    RTCDateTime end = make(2199, 12, 31, 23, 59, 50);
+
+    // Results outside 2000-2199 stop at its ends instead of wrapping
+    CHECK(DS3231::toEpoch(DS3231::addSeconds(start, -6)) == first);
+    CHECK(DS3231::toEpoch(DS3231::addSeconds(make(2010, 6, 1, 12, 0, 0), INT32_MIN)) == first);
+    CHECK(DS3231::toEpoch(DS3231::addDays(start, -1)) == first);
+    CHECK(DS3231::toEpoch(DS3231::addDays(make(2100, 1, 1, 0, 0, 0), INT32_MIN)) == first);
+    CHECK(DS3231::toEpoch(DS3231::addSeconds(end, 10)) == last);
+    CHECK(DS3231::toEpoch(DS3231::addSeconds(make(2180, 1, 1, 0, 0, 0), INT32_MAX)) == last);
+    CHECK(DS3231::toEpoch(DS3231::addDays(end, 1)) == last);
+    CHECK(DS3231::toEpoch(DS3231::addDays(start, INT32_MAX)) == last);
+    CHECK(DS3231::toEpoch(DS3231::fromEpoch(last + 1)) == last);
+    CHECK(DS3231::toEpoch(DS3231::fromEpoch(INT64_MIN / 2)) == first);
+
+    // The last representable step still lands exactly
+    CHECK(DS3231::toEpoch(DS3231::addSeconds(end, 9)) == last);
+    CHECK(DS3231::toEpoch(DS3231::addDays(start, 73048)) == first + 73048LL * 86400 + 5);
+}
+
+static void checkCentury(void)
+{
+    RTCDateTime dt;
+
+    rtc.begin(sim);
+
+    rtc.setDateTime(2099, 12, 31, 23, 59, 59);
+    HostClock::advance(1000000);
+    dt = rtc.getDateTime();
+
+    CHECK((dt.year == 2100) && (dt.month == 1) && (dt.day == 1) && (dt.hour == 0));
+    CHECK(dt.dayOfWeek == 5);
+    CHECK(sim.peek(5) == 0x81);
+    CHECK(sim.peek(6) == 0x00);
+
+    // The chip counts 2100 as a leap year, reading February 29th fixes it
+    rtc.setDateTime(2100, 2, 28, 23, 59, 59);
+    HostClock::advance(1000000);
+    dt = rtc.getDateTime();
+
+    CHECK((dt.month == 3) && (dt.day == 1) && (dt.dayOfWeek == 1));
+
+    HostClock::advance(86400ULL * 1000000);
+    dt = rtc.getDateTime();
+
+    CHECK((dt.month == 3) && (dt.day == 2) && (dt.dayOfWeek == 2));
+
+    rtc.setDateTime(2150, 6, 1, 12, 0, 0);
+    dt = rtc.getDateTime();
+
+    CHECK((dt.year == 2150) && (dt.month == 6) && (dt.day == 1) && (dt.hour == 12));
+    CHECK(DS3231::toEpoch(dt) == reference(dt));
+}
+
+int main(void)
+{
+    checkDays();
+    checkArithmetic();
+    checkSaturation();
+    checkCentury();
+
+    return HostTest::finish("test_calendar");
+}
@@ -0,0 +1,89 @@
+/*
+
+The MIT License
+
+Copyright (c) 2014-2023 Korneliusz Jarzębski
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+/*
+
+Aging offset calibration of a simulated chip running 5.3 ppm fast,
+sampled every ten minutes against the host clock for two weeks.
+
+*/
+
+#include "Arduino.h"
+#include "DS3231.h"
+#include "DS3231Calibration.h"
+#include "DS3231Sim.h"
+#include "HostTest.h"
+
+DS3231Sim sim;
+DS3231 rtc;
+
+void isr(void)
+{
+    rtc.handleSqw();
+}
+
+int main(void)
+{
+    DS3231Calibration calibration(rtc, 86400);
+    RTCPreciseTime p;
+    uint64_t set;
+    uint64_t elapsed;
+    uint32_t base;
+    double offset;
+
+    rtc.begin(sim);
+    sim.setDrift(5300);
+    sim.setInterruptPin(0);
+    attachInterrupt(0, isr, FALLING);
+
+    rtc.setDateTime(2024, 1, 1, 0, 0, 0);
+    set = HostClock::now();
+    base = rtc.getDateTime().unixtime;
+    rtc.enablePreciseClock();
+
+    for (int i = 0; i < 6 * 24 * 14; i++)
+    {
+        HostClock::advance(600000000ULL + (i % 7) * 13);
+        elapsed = HostClock::now() - set;
+        if (calibration.addSample(base + (uint32_t)(elapsed / 1000000), (uint32_t)(elapsed % 1000000)))
+        {
+            // The new offset was applied and nothing is left outstanding
+            CHECK(rtc.isConversionReady());
+            CHECK(!(sim.peek(0x0e) & 0b00100000));
+        }
+    }
+
+    // About 0.1 ppm per step at 25 C
+    CHECK(calibration.isCalibrated());
+    CHECK((rtc.getAging() >= 50) && (rtc.getAging() <= 56));
+
+    elapsed = HostClock::now() - set;
+    p = rtc.now();
+    offset = (int32_t)(p.unixtime - base - elapsed / 1000000) + ((double)p.micros - elapsed % 1000000) / 1e6;
+    CHECK((offset > -1.0) && (offset < 1.0));
+
+    return HostTest::finish("test_calibration");
+}
@@ -0,0 +1,122 @@
+/*
+
+The MIT License
+
+Copyright (c) 2014-2023 Korneliusz Jarzębski
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+/*
+
+The formats compiled by DS3231_FORMAT() against the runtime ones, and the
+calendar rules they fold at compile time.
+
+*/
+
+#include <string.h>
+#include <string>
+
+#include "Arduino.h"
+#include "DS3231.h"
+#include "DS3231Format.h"
+#include "DS3231Sim.h"
+#include "HostTest.h"
+
+static_assert(DS3231Calendar::dayInYear(2024, 3, 1) == 60, "leap day counted");
+static_assert(DS3231Calendar::dayInYear(2100, 12, 31) == 364, "2100 is not leap");
+static_assert(DS3231Calendar::daysInMonth(2000, 2) == 29, "2000 is leap");
+static_assert(DS3231Calendar::hour12(0) == 12, "midnight is 12 am");
+
+#define FORMAT_WORDS "l jS F Y, g:i a z/t L"
+#define FORMAT_CODES "N w y U G h A D M S n j"
+
+typedef DS3231_FORMAT("d-m-Y H:i:s") LongFormat;
+typedef DS3231_FORMAT(FORMAT_WORDS) WordsFormat;
+typedef DS3231_FORMAT(FORMAT_CODES) CodesFormat;
+typedef DS3231_FORMAT("\\at") EscapedFormat;
+
+class StringPrint : public Print
+{
+    public:
+
+	virtual size_t write(uint8_t c)
+	{
+	    text += (char)c;
+	    return 1;
+	}
+
+	std::string text;
+};
+
+DS3231Sim sim;
+DS3231 rtc;
+
+static void checkCompiled(void)
+{
+    RTCDateTime dt;
+    StringPrint out;
+    char runtime[64];
+
+    static_assert(LongFormat::size == 20, "d-m-Y H:i:s is 19 characters");
+
+    for (uint32_t t = 946684800UL; t < 1735689599UL; t += 86400UL * 3 + 3671)
+    {
+        char words[WordsFormat::size];
+        char codes[CodesFormat::size];
+
+        dt = DS3231::loadDateTimeFromLong(t);
+
+        WordsFormat::format(words, dt);
+        rtc.dateFormat(runtime, sizeof(runtime), FORMAT_WORDS, dt);
+        CHECK(!strcmp(words, runtime));
+
+        CodesFormat::format(codes, dt);
+        rtc.dateFormat(runtime, sizeof(runtime), FORMAT_CODES, dt);
+        CHECK(!strcmp(codes, runtime));
+    }
+
+    dt = DS3231::loadDateTimeFromLong(1709161507UL);
+
+    char words[WordsFormat::size];
+    WordsFormat::format(words, dt);
+    CHECK(!strcmp(words, "Wednesday 28th February 2024, 11:05 pm 58/29 1"));
+
+    // Only compiled formats escape letters
+    char escaped[EscapedFormat::size];
+    EscapedFormat::format(escaped, dt);
+    CHECK(!strcmp(escaped, "a29"));
+
+    char buffer[LongFormat::size];
+    CHECK(LongFormat::format(buffer, dt) == 19);
+    CHECK(!strcmp(buffer, "28-02-2024 23:05:07"));
+
+    LongFormat::print(out, dt);
+    CHECK(out.text == "28-02-2024 23:05:07");
+}
+
+int main(void)
+{
+    rtc.begin(sim);
+
+    checkCompiled();
+
+    return HostTest::finish("test_compiled");
+}
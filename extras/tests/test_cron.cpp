@@ -0,0 +1,161 @@
+/*
+
+The MIT License
+
+Copyright (c) 2014-2023 Korneliusz Jarzębski
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+/*
+
+Cron parsing, next() against matches() minute by minute, and schedules
+run on the simulated alarm 2.
+
+*/
+
+#include "Arduino.h"
+#include "DS3231.h"
+#include "DS3231Cron.h"
+#include "DS3231Sim.h"
+#include "HostTest.h"
+
+DS3231Sim sim;
+DS3231 rtc;
+
+static void checkParse(void)
+{
+    const char *valid[] = { "* * * * *", "30 * * * *", "0 7 * * *", "15 6 13 * *", "0 7 * * 1", "0 7 * * 0", "0 7 * * 7",
+        "*/15 8-18 * * 1-5", "0 0 29 2 *", "0 0 30 2 *", "0 12 13 * 5", "5,35 */2 1-7 * 0", "0 0 31 * *", "0 0 1 1 *", "1-2/250 * * * *" };
+    const char *invalid[] = { "bad", "61 * * * *", "*/0 * * * *", "* * * *", "* * * * * *", "5-1 * * * *", "* * 0 * *" };
+    DS3231Cron cron;
+
+    for (const char *expression : valid)
+    {
+        CHECK(cron.parse(expression));
+    }
+
+    for (const char *expression : invalid)
+    {
+        CHECK(!cron.parse(expression));
+    }
+
+    // Schedules the chip repeats on its own are never rewritten
+    cron.parse("30 * * * *");
+    CHECK(!cron.needsRearm() && (cron.getAlarmType2() == DS3231_MATCH_M));
+    cron.parse("0 7 * * 1");
+    CHECK(!cron.needsRearm() && (cron.getAlarmType2() == DS3231_MATCH_DY_H_M));
+    cron.parse("*/15 8-18 * * 1-5");
+    CHECK(cron.needsRearm());
+
+    // A stepped * restricts the field, only a bare * is every day
+    cron.parse("0 7 */2 * *");
+    CHECK(cron.needsRearm());
+    cron.parse("0 7 * * */2");
+    CHECK(cron.needsRearm());
+    cron.parse("0 7 1-31 * *");
+    CHECK(!cron.needsRearm() && (cron.getAlarmType2() == DS3231_MATCH_H_M));
+    cron.parse("0 7 1-31 * 1");
+    CHECK(!cron.needsRearm() && (cron.getAlarmType2() == DS3231_MATCH_H_M));
+    cron.parse("0 7 15 * 1");
+    CHECK(cron.needsRearm());
+}
+
+static void checkNext(void)
+{
+    const char *expressions[] = { "* * * * *", "30 * * * *", "0 7 * * *", "15 6 13 * *", "0 7 * * 1", "0 7 * * 7",
+        "*/15 8-18 * * 1-5", "0 0 29 2 *", "0 12 13 * 5", "5,35 */2 1-7 * 0", "0 0 31 * *", "0 0 1 1 *", "1-2/250 * * * *",
+        "0 7 */2 * *", "0 7 * * */2", "0 7 1-31 * 1", "0 7 15 * 1" };
+    const uint32_t start = 946684800UL + 86400UL * 3000 + 1234;
+
+    for (const char *expression : expressions)
+    {
+        DS3231Cron cron;
+        uint32_t next;
+        int found = 0;
+
+        cron.parse(expression);
+        next = cron.next(start);
+
+        // Leap days are years apart, the scan covers 60 days
+        for (uint32_t t = start - start % 60 + 60; (t < start + 86400UL * 60) && (found < 20); t += 60)
+        {
+            if (cron.matches(DS3231::loadDateTimeFromLong(t)))
+            {
+                CHECK(t == next);
+                next = cron.next(t);
+                found++;
+            }
+        }
+
+        CHECK(found || !strcmp(expression, "0 0 29 2 *") || !strcmp(expression, "0 0 1 1 *"));
+    }
+}
+
+static void checkAlarm(const char *expression, int expected)
+{
+    DS3231Cron cron;
+    RTCDateTime dt;
+    int fires = 0;
+    int wrong = 0;
+
+    cron.parse(expression);
+
+    // A week from Monday 2024-02-26
+    rtc.setDateTime(2024, 2, 26, 0, 0, 0);
+    rtc.enableOutput(false);
+    cron.setAlarm2(rtc, rtc.getDateTime().unixtime);
+
+    for (int i = 0; i < 7 * 24 * 60; i++)
+    {
+        delay(60000);
+
+        if (rtc.isAlarm2())
+        {
+            dt = rtc.getDateTime();
+            dt.second = 0;
+            wrong += !cron.matches(dt);
+            fires++;
+
+            if (cron.needsRearm())
+            {
+                cron.setAlarm2(rtc, dt.unixtime);
+            }
+        }
+    }
+
+    CHECK(fires == expected);
+    CHECK(wrong == 0);
+}
+
+int main(void)
+{
+    rtc.begin(sim);
+
+    checkParse();
+    checkNext();
+    checkAlarm("30 * * * *", 7 * 24);
+    checkAlarm("0 7 * * 1", 1);
+    checkAlarm("*/15 8-18 * * 1-5", 5 * 11 * 4);
+    checkAlarm("0 7 */2 * *", 4);
+    checkAlarm("0 7 * * */2", 4);
+
+    return HostTest::finish("test_cron");
+}
@@ -0,0 +1,177 @@
+/*
+
+The MIT License
+
+Copyright (c) 2014-2023 Korneliusz Jarzębski
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+/*
+
+Alarm events queued from the interrupt and handled by process().
+
+*/
+
+#include "Arduino.h"
+#include "DS3231.h"
+#include "DS3231Events.h"
+#include "DS3231Sim.h"
+#include "HostTest.h"
+
+DS3231Sim sim;
+DS3231 rtc;
+
+uint32_t queue[8];
+DS3231Events events(rtc, queue, 8);
+
+// Raises alarm 2 between the STATUS read and its write back
+class RacingBus : public DS3231Bus
+{
+    public:
+
+    bool race;
+
+    RacingBus(void) : race(false)
+    {
+    }
+
+    virtual bool readRegisters(uint8_t address, uint8_t reg, uint8_t *values, uint8_t count)
+    {
+        return sim.readRegisters(address, reg, values, count);
+    }
+
+    virtual bool writeRegisters(uint8_t address, uint8_t reg, const uint8_t *values, uint8_t count)
+    {
+        if (race && (reg == 0x0f))
+        {
+            sim.poke(0x0f, sim.peek(0x0f) | DS3231_ALARM_2);
+            race = false;
+        }
+
+        return sim.writeRegisters(address, reg, values, count);
+    }
+};
+
+int fired1 = 0;
+int fired2 = 0;
+
+void isr(void)
+{
+    events.handleInterrupt();
+}
+
+void alarm1(uint32_t)
+{
+    fired1++;
+}
+
+void alarm2(uint32_t)
+{
+    fired2++;
+}
+
+static void checkRace(void)
+{
+    RacingBus bus;
+    DS3231 clock;
+    uint32_t slots[4];
+    DS3231Events racing(clock, slots, 4);
+
+    clock.begin(bus);
+    clock.enableOutput(false);
+    clock.armAlarm1(true);
+    clock.armAlarm2(true);
+    clock.clearAlarm1();
+    clock.clearAlarm2();
+    fired1 = 0;
+    fired2 = 0;
+    racing.setHandler1(alarm1);
+    racing.setHandler2(alarm2);
+
+    sim.poke(0x0f, sim.peek(0x0f) | DS3231_ALARM_1);
+    racing.handleInterrupt();
+    bus.race = true;
+    racing.process();
+
+    // Both handled and INT released, so the next alarm brings an edge
+    CHECK((fired1 == 1) && (fired2 == 1));
+    CHECK(sim.readInterruptPin());
+}
+
+static void checkSize(void)
+{
+    uint32_t slots[12];
+    DS3231Events none(rtc, slots, 0);
+    DS3231Events twelve(rtc, slots, 12);
+
+    none.handleInterrupt();
+    CHECK(none.available() == 0);
+    CHECK(none.getOverflows() == 1);
+
+    for (int i = 0; i < 12; i++)
+    {
+        twelve.handleInterrupt();
+    }
+
+    CHECK(twelve.available() == 8);
+    CHECK(twelve.getOverflows() == 4);
+}
+
+int main(void)
+{
+    rtc.begin(sim);
+    rtc.enableOutput(false);
+    sim.setInterruptPin(0);
+    attachInterrupt(0, isr, FALLING);
+
+    rtc.setDateTime(2024, 1, 1, 0, 0, 0);
+    events.setHandler1(alarm1);
+    events.setHandler2(alarm2);
+    rtc.setAlarm1(0, 0, 0, 10, DS3231_MATCH_S);
+    rtc.setAlarm2(0, 0, 0, DS3231_EVERY_MINUTE);
+
+    // One hour, processed every 100 ms
+    for (int i = 0; i < 36000; i++)
+    {
+        delay(100);
+        events.process();
+    }
+
+    CHECK(fired1 == 60);
+    CHECK(fired2 == 60);
+    // A loop period plus the transfers
+    CHECK(events.getMaxLatency() < 102000UL);
+    CHECK(events.getOverflows() == 0);
+
+    // The queue keeps the oldest events and counts the rest
+    for (int i = 0; i < 20; i++)
+    {
+        events.handleInterrupt();
+    }
+
+    CHECK(events.available() == 8);
+    CHECK(events.getOverflows() == 12);
+
+    checkRace();
+    checkSize();
+
+    return HostTest::finish("test_events");
+}
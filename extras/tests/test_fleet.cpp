@@ -0,0 +1,126 @@
+/*
+
+The MIT License
+
+Copyright (c) 2014-2023 Korneliusz Jarzębski
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+/*
+
+Five clocks behind a simulated TCA9548A read as a fleet, and a clock on
+the alternate address.
+
+*/
+
+#include "Arduino.h"
+#include "DS3231.h"
+#include "DS3231Fleet.h"
+#include "DS3231Mux.h"
+#include "DS3231Sim.h"
+#include "DS3231SimMux.h"
+#include "HostTest.h"
+
+DS3231SimMux simMux;
+DS3231Sim sims[5];
+DS3231Mux mux(simMux);
+DS3231MuxChannel channels[5] = { DS3231MuxChannel(mux, 0), DS3231MuxChannel(mux, 1), DS3231MuxChannel(mux, 2),
+    DS3231MuxChannel(mux, 3), DS3231MuxChannel(mux, 4) };
+DS3231 clocks[5];
+DS3231Fleet fleet(1);
+
+static void checkFleet(void)
+{
+    RTCDateTime median;
+    uint8_t both = 0b00000011;
+    uint8_t values[7];
+
+    for (int i = 0; i < 5; i++)
+    {
+        simMux.attach(i, sims[i]);
+        clocks[i].begin(channels[i]);
+        fleet.add(clocks[i]);
+    }
+
+    // Three agree within a second, one is an hour off, one two seconds
+    clocks[0].setDateTime(2024, 5, 1, 12, 0, 0);
+    clocks[1].setDateTime(2024, 5, 1, 12, 0, 1);
+    clocks[2].setDateTime(2024, 5, 1, 12, 0, 0);
+    clocks[3].setDateTime(2024, 5, 1, 11, 0, 0);
+    clocks[4].setDateTime(2024, 5, 1, 12, 0, 2);
+
+    for (int round = 0; round < 4; round++)
+    {
+        simMux.resetCounters();
+
+        CHECK(fleet.read() == 5);
+        CHECK(fleet.getAgreeing() == 3);
+        CHECK(fleet.hasConsensus());
+
+        // The channel left selected by the last round is reused
+        CHECK((round == 0) || (simMux.getSelects() == 4));
+
+        median = fleet.getMedian();
+        CHECK((median.hour == 12) && (median.minute == 0) && (median.second == 0));
+
+        for (int i = 0; i < 5; i++)
+        {
+            CHECK(fleet.isResponding(i));
+            CHECK(fleet.isAgreeing(i) == (i < 3));
+        }
+
+        HostClock::advance(100000);
+    }
+
+    simMux.detach(2);
+    simMux.detach(0);
+    CHECK(fleet.read() == 3);
+    CHECK(!fleet.hasConsensus());
+    CHECK(!fleet.isResponding(0) && !fleet.isResponding(2));
+
+    // Two channels selected at once make the read collide
+    simMux.attach(0, sims[0]);
+    mux.invalidate();
+    simMux.writeRegisters(0x70, both, &both, 0);
+    CHECK(!simMux.readRegisters(DS3231_ADDRESS, 0x00, values, 7));
+}
+
+static void checkAddress(void)
+{
+    DS3231Sim chip(0x69);
+    DS3231 rtc(0x69);
+    RTCDateTime dt;
+
+    rtc.begin(chip);
+    CHECK(rtc.getAddress() == 0x69);
+
+    rtc.setDateTime(2030, 1, 2, 3, 4, 5);
+    dt = rtc.getDateTime();
+    CHECK((dt.year == 2030) && (dt.month == 1) && (dt.day == 2) && (dt.hour == 3) && (dt.minute == 4) && (dt.second == 5));
+}
+
+int main(void)
+{
+    checkFleet();
+    checkAddress();
+
+    return HostTest::finish("test_fleet");
+}
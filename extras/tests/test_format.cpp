@@ -0,0 +1,68 @@
+/*
+
+The MIT License
+
+Copyright (c) 2014-2023 Korneliusz Jarzębski
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+/*
+
+dateFormat() into the shared buffer and into a caller buffer.
+
+*/
+
+#include <string.h>
+
+#include "Arduino.h"
+#include "DS3231.h"
+#include "DS3231Sim.h"
+#include "HostTest.h"
+
+DS3231Sim sim;
+DS3231 rtc;
+
+static void checkRuntime(void)
+{
+    RTCDateTime dt;
+    RTCAlarmTime alarm = { 3, 13, 4, 9 };
+    char buffer[12];
+
+    rtc.begin(sim);
+    rtc.setDateTime(2024, 2, 29, 0, 5, 7);
+    dt = rtc.getDateTime();
+
+    CHECK(!strcmp(rtc.dateFormat("d-m-Y H:i:s l D jS F M N w z t y L h g A a G U \\x", dt),
+        "29-02-2024 00:05:07 Thursday Thu 29th February Feb 4 4 59 29 24 1 12 12 AM am 0 1709165107 \\x"));
+    CHECK(!strcmp(rtc.dateFormat("d H:i:s l D N w S h g A Y m", alarm), "03 13:04:09 Wednesday Wed 3 3 rd 01 1 PM Y m"));
+
+    // Truncated to the buffer, the return value is what was written
+    CHECK(rtc.dateFormat(buffer, sizeof(buffer), "l, F jS", dt) == 11);
+    CHECK(!strcmp(buffer, "Thursday, F"));
+    CHECK(rtc.dateFormat(buffer, 0, "Y", dt) == 0);
+}
+
+int main(void)
+{
+    checkRuntime();
+
+    return HostTest::finish("test_format");
+}
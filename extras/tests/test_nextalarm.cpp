@@ -0,0 +1,161 @@
+/*
+
+The MIT License
+
+Copyright (c) 2014-2023 Korneliusz Jarzębski
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+/*
+
+nextAlarm1() and nextAlarm2() against a second by second scan.
+
+*/
+
+#include <stdlib.h>
+
+#include "Arduino.h"
+#include "DS3231.h"
+#include "HostTest.h"
+
+static bool matches1(const RTCDateTime &dt, const RTCAlarmTime &alarm, DS3231_alarm1_t mode)
+{
+    switch (mode)
+    {
+        case DS3231_EVERY_SECOND: return true;
+        case DS3231_MATCH_S: return dt.second == alarm.second;
+        case DS3231_MATCH_M_S: return (dt.second == alarm.second) && (dt.minute == alarm.minute);
+        case DS3231_MATCH_H_M_S: return (dt.second == alarm.second) && (dt.minute == alarm.minute) && (dt.hour == alarm.hour);
+        case DS3231_MATCH_DT_H_M_S: return (dt.second == alarm.second) && (dt.minute == alarm.minute) && (dt.hour == alarm.hour) && (dt.day == alarm.day);
+        case DS3231_MATCH_DY_H_M_S: return (dt.second == alarm.second) && (dt.minute == alarm.minute) && (dt.hour == alarm.hour) && (dt.dayOfWeek == alarm.day);
+    }
+
+    return false;
+}
+
+static bool matches2(const RTCDateTime &dt, const RTCAlarmTime &alarm, DS3231_alarm2_t mode)
+{
+    if (dt.second != 0)
+    {
+        return false;
+    }
+
+    switch (mode)
+    {
+        case DS3231_EVERY_MINUTE: return true;
+        case DS3231_MATCH_M: return dt.minute == alarm.minute;
+        case DS3231_MATCH_H_M: return (dt.minute == alarm.minute) && (dt.hour == alarm.hour);
+        case DS3231_MATCH_DT_H_M: return (dt.minute == alarm.minute) && (dt.hour == alarm.hour) && (dt.day == alarm.day);
+        case DS3231_MATCH_DY_H_M: return (dt.minute == alarm.minute) && (dt.hour == alarm.hour) && (dt.dayOfWeek == alarm.day);
+    }
+
+    return false;
+}
+
+// First match after now, scanning seconds then skipping whole units once
+// the finer fields match. Zero when nothing matches within 130 days.
+static uint32_t scan(uint32_t now, const RTCAlarmTime &alarm, int mode, bool second)
+{
+    for (uint32_t t = now + 1; t < now + 86400UL * 130; )
+    {
+        RTCDateTime dt = DS3231::loadDateTimeFromLong(t);
+
+        if (second ? matches1(dt, alarm, (DS3231_alarm1_t)mode) : matches2(dt, alarm, (DS3231_alarm2_t)mode))
+        {
+            return t;
+        }
+
+        if (dt.second != (second ? alarm.second : 0))
+        {
+            t += ((second ? alarm.second : 0) - dt.second + 60) % 60;
+        } else if (dt.minute != alarm.minute)
+        {
+            t += 60;
+        } else if (dt.hour != alarm.hour)
+        {
+            t += 3600;
+        } else
+        {
+            t += 86400;
+        }
+    }
+
+    return 0;
+}
+
+static void checkNext(void)
+{
+    const DS3231_alarm1_t modes1[] = { DS3231_EVERY_SECOND, DS3231_MATCH_S, DS3231_MATCH_M_S, DS3231_MATCH_H_M_S, DS3231_MATCH_DT_H_M_S, DS3231_MATCH_DY_H_M_S };
+    const DS3231_alarm2_t modes2[] = { DS3231_EVERY_MINUTE, DS3231_MATCH_M, DS3231_MATCH_H_M, DS3231_MATCH_DT_H_M, DS3231_MATCH_DY_H_M };
+
+    srand(1);
+
+    for (int i = 0; i < 3000; i++)
+    {
+        uint32_t now = 946684800UL + (uint32_t)((uint64_t)rand() * rand() % (86400ULL * 365 * 90));
+        RTCDateTime dt = DS3231::loadDateTimeFromLong(now);
+        RTCAlarmTime alarm = { (uint8_t)(rand() % 28 + 1), (uint8_t)(rand() % 24), (uint8_t)(rand() % 60), (uint8_t)(rand() % 60) };
+        DS3231_alarm1_t mode1 = modes1[rand() % 6];
+        DS3231_alarm2_t mode2 = modes2[rand() % 5];
+        uint32_t expected;
+
+        // A third of them exactly on the current time
+        if (i % 3 == 0)
+        {
+            alarm.day = dt.day;
+            alarm.hour = dt.hour;
+            alarm.minute = dt.minute;
+            alarm.second = dt.second;
+        }
+
+        if (mode1 == DS3231_MATCH_DY_H_M_S)
+        {
+            alarm.day = (i % 3 == 0) ? dt.dayOfWeek : (rand() % 7 + 1);
+        }
+
+        expected = scan(now, alarm, mode1, true);
+        CHECK(expected && (DS3231::nextAlarm1(dt, alarm, mode1) == expected));
+
+        if (mode2 == DS3231_MATCH_DY_H_M)
+        {
+            alarm.day = (i % 3 == 0) ? dt.dayOfWeek : (rand() % 7 + 1);
+        }
+
+        expected = scan(now, alarm, mode2, false);
+        CHECK(expected && (DS3231::nextAlarm2(dt, alarm, mode2) == expected));
+    }
+
+    // Day 29 skips a February without one
+    RTCAlarmTime day29 = { 29, 0, 0, 0 };
+    RTCDateTime next = DS3231::loadDateTimeFromLong(DS3231::nextAlarm1(DS3231::loadDateTimeFromLong(946684800UL + 86400UL * 365 * 3), day29, DS3231_MATCH_DT_H_M_S));
+    CHECK((next.year == 2003) && (next.month == 1) && (next.day == 29));
+
+    RTCAlarmTime day31 = { 31, 12, 0, 0 };
+    next = DS3231::loadDateTimeFromLong(DS3231::nextAlarm2(DS3231::loadDateTimeFromLong(946684800UL + 86400UL * (365 * 3 + 31 + 28 + 31 + 1)), day31, DS3231_MATCH_DT_H_M));
+    CHECK((next.month == 5) && (next.day == 31) && (next.hour == 12));
+}
+
+int main(void)
+{
+    checkNext();
+
+    return HostTest::finish("test_nextalarm");
+}
@@ -0,0 +1,167 @@
+/*
+
+The MIT License
+
+Copyright (c) 2014-2023 Korneliusz Jarzębski
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+/*
+
+__DATE__/__TIME__, ISO 8601 and RFC 3339 parsing, the last two against
+strftime() output, and the compile-time build epoch.
+
+*/
+
+#include <stdlib.h>
+#include <time.h>
+
+#include "Arduino.h"
+#include "DS3231.h"
+#include "DS3231BuildTime.h"
+#include "DS3231Sim.h"
+#include "HostTest.h"
+
+static_assert(DS3231Calendar::days(2100, 3, 1) == 36584, "no 2100-02-29");
+static_assert(DS3231BuildTime::epoch("Jan  1 2000", "00:00:00", 0) == 946684800UL, "epoch start");
+static_assert(DS3231BuildTime::epoch("Mar  1 2100", "12:34:56", 3600) == 4107584096UL, "after 2100-02-28");
+static_assert(DS3231_BUILD_TIME(0) - DS3231_BUILD_TIME(3600) == 3600, "folded by the compiler");
+
+DS3231Sim sim;
+DS3231 rtc;
+
+static void checkBuildTime(void)
+{
+    const char *months[] = { "Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec" };
+    const char *invalid[] = { "Foo 12 2024", "Jan 32 2024", "Feb 29 2023", "Jan 1 2024", "Jan 12 24", "Jan 12 2024 " };
+    RTCDateTime dt;
+
+    for (int m = 0; m < 12; m++)
+    {
+        char date[12];
+
+        snprintf(date, sizeof(date), "%s %2d 2024", months[m], m + 3);
+        CHECK(DS3231::parseDateTime(date, "13:14:15", dt));
+        CHECK((dt.month == m + 1) && (dt.day == m + 3));
+        CHECK(DS3231BuildTime::epoch(date, "13:14:15", 0) == dt.unixtime);
+    }
+
+    CHECK(DS3231::parseDateTime(__DATE__, __TIME__, dt));
+    CHECK(dt.unixtime == DS3231_BUILD_TIME(0));
+
+    for (const char *date : invalid)
+    {
+        CHECK(!DS3231::parseDateTime(date, "10:00:00", dt));
+    }
+
+    CHECK(!DS3231::parseDateTime("Jan 12 2024", "10:00", dt));
+    CHECK(!DS3231::parseDateTime("Jan 12 2024", "1a:00:00", dt));
+}
+
+static void checkRandom(void)
+{
+    RTCDateTime dt;
+
+    srand(9);
+
+    for (int i = 0; i < 100000; i++)
+    {
+        uint32_t t = 946684800UL + ((uint64_t)rand() * rand()) % (86400ULL * 365 * 100);
+        int32_t offset = (rand() % 27 - 13) * 1800;
+        time_t seconds = t;
+        time_t local = t + offset;
+        struct tm tm;
+        char text[48];
+
+        gmtime_r(&seconds, &tm);
+        strftime(text, sizeof(text), "%Y-%m-%dT%H:%M:%SZ", &tm);
+        CHECK(DS3231::parseRfc3339(text, dt) && (dt.unixtime == t));
+
+        gmtime_r(&local, &tm);
+        strftime(text, sizeof(text), "%Y-%m-%d %H:%M:%S", &tm);
+        snprintf(text + 19, sizeof(text) - 19, ".123%c%02d:%02d", (offset < 0) ? '-' : '+', abs(offset) / 3600, abs(offset) % 3600 / 60);
+
+        // Local times before 2000 cannot be represented
+        if (local >= 946684800L)
+        {
+            CHECK(DS3231::parseIso8601(text, dt) && (dt.unixtime == t));
+        }
+    }
+}
+
+static void checkCases(void)
+{
+    struct
+    {
+        const char *text;
+        bool iso;
+        bool rfc;
+    } cases[] = {
+        { "2024-02-29", true, false }, { "2023-02-29", false, false }, { "2024-13-01", false, false },
+        { "2024-01-01T24:00:00Z", false, false }, { "2024-01-01T10:00", true, false }, { "2024-01-01T10:00Z", true, false },
+        { "2024-01-01T10:00:00", true, false }, { "2024-01-01t10:00:00z", true, true }, { "2024-01-01T10:00:00+0100", true, false },
+        { "2024-01-01T10:00:00+01", true, false }, { "2024-01-01T10:00:00,5Z", true, false }, { "2024-01-01T10:00:00.Z", false, false },
+        { "2024-1-01", false, false }, { "1999-12-31T23:00:00Z", false, false }, { "2000-01-01T00:30:00+01:00", false, false },
+        { "2199-12-31T23:59:59Z", true, true }, { "2200-01-01", false, false }, { "2024-01-01T10:00:00Zx", false, false },
+        { "2024-01-01X10:00:00Z", false, false }, { "", false, false }, { "2024-01-01T10:00:60Z", false, false },
+        { "2024-06-30T23:00:00-02:00", true, true } };
+    RTCDateTime dt;
+
+    for (auto &c : cases)
+    {
+        CHECK(DS3231::parseIso8601(c.text, dt) == c.iso);
+        CHECK(DS3231::parseRfc3339(c.text, dt) == c.rfc);
+    }
+
+    DS3231::parseIso8601("2024-06-30T23:00:00-02:00", dt);
+    CHECK((dt.month == 7) && (dt.day == 1) && (dt.hour == 1) && (dt.dayOfWeek == 1));
+}
+
+static void checkSet(void)
+{
+    RTCDateTime dt;
+
+    rtc.begin(sim);
+    rtc.setDateTime(2030, 1, 1, 0, 0, 0);
+
+    // A rejected string leaves the clock alone
+    CHECK(!rtc.setDateTime("Jux 12 2024", "10:00:00"));
+    CHECK(rtc.getDateTime().year == 2030);
+
+    CHECK(rtc.setDateTime("Jul  4 2024", "10:00:00"));
+    dt = rtc.getDateTime();
+    CHECK((dt.year == 2024) && (dt.month == 7) && (dt.day == 4) && (dt.hour == 10) && (dt.dayOfWeek == 4));
+
+    DS3231::parseRfc3339("2150-03-01T00:00:00Z", dt);
+    rtc.setDateTime(dt);
+    dt = rtc.getDateTime();
+    CHECK((dt.year == 2150) && (dt.month == 3) && (dt.day == 1) && (dt.dayOfWeek == 7));
+}
+
+int main(void)
+{
+    checkBuildTime();
+    checkRandom();
+    checkCases();
+    checkSet();
+
+    return HostTest::finish("test_parse");
+}
@@ -0,0 +1,70 @@
+/*
+
+The MIT License
+
+Copyright (c) 2014-2023 Korneliusz Jarzębski
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+/*
+
+pollAlarms(): both alarm flags and OSF read and acknowledged in one go.
+
+*/
+
+#include "Arduino.h"
+#include "DS3231.h"
+#include "DS3231Sim.h"
+#include "HostTest.h"
+
+DS3231Sim sim;
+DS3231 rtc;
+
+static void checkPoll(void)
+{
+    uint8_t flags;
+
+    rtc.begin(sim);
+
+    // Every second and every minute, both flags read and cleared in one go
+    rtc.setDateTime(2024, 5, 1, 10, 0, 0);
+    rtc.setAlarm1(0, 0, 0, 0, DS3231_EVERY_SECOND);
+    rtc.setAlarm2(0, 0, 0, DS3231_EVERY_MINUTE);
+    delay(60500);
+    CHECK(sim.peek(DS3231_REG_STATUS) == 0x8B);
+
+    sim.resetCounters();
+    flags = rtc.pollAlarms();
+    CHECK(flags == 0x83);
+    CHECK(sim.getTransactions() == 3);
+    CHECK(sim.peek(DS3231_REG_STATUS) == 0x88);
+
+    flags = rtc.pollAlarms(DS3231_STOPPED);
+    CHECK(flags == 0x80);
+    CHECK(sim.peek(DS3231_REG_STATUS) == 0x08);
+}
+
+int main(void)
+{
+    checkPoll();
+
+    return HostTest::finish("test_poll");
+}
@@ -0,0 +1,82 @@
+/*
+
+The MIT License
+
+Copyright (c) 2014-2023 Korneliusz Jarzębski
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+/*
+
+Sub-second time from SQW edges. The host clock is the reference: the
+simulator starts a second when its seconds register is written.
+
+*/
+
+#include <math.h>
+
+#include "Arduino.h"
+#include "DS3231.h"
+#include "DS3231Sim.h"
+#include "HostTest.h"
+
+DS3231Sim sim;
+DS3231 rtc;
+
+void isr(void)
+{
+    rtc.handleSqw();
+}
+
+static void checkNow(void)
+{
+    uint64_t set;
+
+    delayMicroseconds(123456);
+    rtc.setDateTime(2023, 5, 19, 12, 0, 0);
+    set = HostClock::now();
+    delay(2300);
+
+    for (int i = 0; i < 5; i++)
+    {
+        RTCPreciseTime p;
+        double elapsed;
+
+        delayMicroseconds(137777);
+        p = rtc.now();
+        elapsed = (HostClock::now() - set) / 1e6;
+
+        CHECK(fabs((p.unixtime - 1684497600UL) + p.micros / 1e6 - elapsed) < 0.002);
+        CHECK(rtc.getSqwPeriod() == 1000000UL);
+    }
+}
+
+int main(void)
+{
+    rtc.begin(sim);
+    sim.setInterruptPin(0);
+    attachInterrupt(0, isr, FALLING);
+    rtc.enablePreciseClock();
+
+    checkNow();
+
+    return HostTest::finish("test_precise");
+}
@@ -0,0 +1,79 @@
+/*
+
+The MIT License
+
+Copyright (c) 2014-2023 Korneliusz Jarzębski
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+/*
+
+dateFormat() streamed to a Print.
+
+*/
+
+#include <string>
+
+#include "Arduino.h"
+#include "DS3231.h"
+#include "DS3231Sim.h"
+#include "HostTest.h"
+
+class StringPrint : public Print
+{
+    public:
+
+	virtual size_t write(uint8_t c)
+	{
+	    text += (char)c;
+	    return 1;
+	}
+
+	std::string text;
+};
+
+DS3231Sim sim;
+DS3231 rtc;
+
+static void checkPrint(void)
+{
+    RTCDateTime dt;
+    RTCAlarmTime alarm = { 3, 13, 4, 9 };
+    StringPrint out;
+
+    rtc.begin(sim);
+    rtc.setDateTime(2024, 2, 29, 0, 5, 7);
+    dt = rtc.getDateTime();
+
+    CHECK(rtc.dateFormat(out, "d-m-Y H:i:s l", dt) == 28);
+    CHECK(out.text == "29-02-2024 00:05:07 Thursday");
+
+    out.text = "";
+    rtc.dateFormat(out, "d H:i:s D Y", alarm);
+    CHECK(out.text == "03 13:04:09 Wed Y");
+}
+
+int main(void)
+{
+    checkPrint();
+
+    return HostTest::finish("test_print");
+}
@@ -0,0 +1,68 @@
+/*
+
+The MIT License
+
+Copyright (c) 2014-2023 Korneliusz Jarzębski
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+/*
+
+Quarter degree temperatures without floating point, read directly and
+from a snapshot.
+
+*/
+
+#include <initializer_list>
+
+#include "Arduino.h"
+#include "DS3231.h"
+#include "DS3231Sim.h"
+#include "HostTest.h"
+
+DS3231Sim sim;
+DS3231 rtc;
+
+static void checkQuarters(void)
+{
+    for (int quarters : { 100, 103, -1, -2, -100, -511, 511, 0 })
+    {
+        DS3231Snapshot snapshot;
+
+        sim.setTemperature(quarters);
+        rtc.forceConversion();
+        rtc.readSnapshot(snapshot);
+
+        CHECK(rtc.readTemperatureQuarters() == quarters);
+        CHECK(rtc.readTemperature() == quarters / 4.0f);
+        CHECK(snapshot.getTemperatureQuarters() == quarters);
+        CHECK(snapshot.getTemperature() == quarters / 4.0f);
+    }
+}
+
+int main(void)
+{
+    rtc.begin(sim);
+
+    checkQuarters();
+
+    return HostTest::finish("test_quarters");
+}
@@ -0,0 +1,112 @@
+/*
+
+The MIT License
+
+Copyright (c) 2014-2023 Korneliusz Jarzębski
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+/*
+
+setPreciseTime() against the host clock, from a reference taken a while
+before the call and over a faster bus.
+
+*/
+
+#include <math.h>
+
+#include "Arduino.h"
+#include "DS3231.h"
+#include "DS3231Sim.h"
+#include "HostTest.h"
+
+DS3231Sim sim;
+DS3231 rtc;
+
+// Unix time the host clock started at
+static const double origin = 1700000000.0 - 0.3;
+
+void isr(void)
+{
+    rtc.handleSqw();
+}
+
+static double truth(void)
+{
+    return origin + HostClock::now() / 1e6;
+}
+
+static double offset(DS3231 &clock)
+{
+    RTCPreciseTime p = clock.now();
+
+    return (p.unixtime + p.micros / 1e6) - truth();
+}
+
+static RTCPreciseTime reference(uint32_t &at)
+{
+    RTCPreciseTime r;
+    double t;
+
+    at = micros();
+    t = truth();
+    r.unixtime = (uint32_t)t;
+    r.micros = (uint32_t)((t - r.unixtime) * 1e6);
+
+    return r;
+}
+
+static void checkSetPrecise(void)
+{
+    RTCPreciseTime r;
+    uint32_t at;
+
+    for (int k = 0; k < 5; k++)
+    {
+        delayMicroseconds(123457 * k + 99);
+
+        // The reference was taken a while before the call
+        r = reference(at);
+        delayMicroseconds(20000 * k);
+
+        CHECK(rtc.setPreciseTime(r, at));
+        delay(2500);
+        CHECK(fabs(offset(rtc)) < 0.0002);
+    }
+
+    sim.setBusClock(400000);
+    r = reference(at);
+    CHECK(rtc.setPreciseTime(r, at));
+    delay(2500);
+    CHECK(fabs(offset(rtc)) < 0.0002);
+}
+
+int main(void)
+{
+    rtc.begin(sim);
+    sim.setInterruptPin(0);
+    attachInterrupt(0, isr, FALLING);
+    rtc.enablePreciseClock();
+
+    checkSetPrecise();
+
+    return HostTest::finish("test_setprecise");
+}
@@ -0,0 +1,75 @@
+/*
+
+The MIT License
+
+Copyright (c) 2014-2023 Korneliusz Jarzębski
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+/*
+
+The simulator on the host Wire, with the time skipped ahead: an hour of
+counting and a week of alarms every minute.
+
+*/
+
+#include "Arduino.h"
+#include "Wire.h"
+#include "DS3231.h"
+#include "DS3231Sim.h"
+#include "HostTest.h"
+
+static void checkWire(void)
+{
+    DS3231Sim wired;
+    DS3231 clock;
+    RTCDateTime dt;
+    int fired = 0;
+
+    // Through the host Wire instead of the DS3231Bus of the simulator
+    Wire.attach(DS3231_ADDRESS, wired);
+    clock.begin();
+    clock.setDateTime(2023, 5, 19, 12, 0, 0);
+
+    HostClock::advance(3600ULL * 1000000);
+    dt = clock.getDateTime();
+    CHECK((dt.hour == 13) && (dt.minute == 0) && (dt.dayOfWeek == 5));
+
+    clock.setAlarm2(0, 0, 0, DS3231_EVERY_MINUTE);
+    clock.enableOutput(false);
+
+    for (int i = 0; i < 7 * 24 * 60; i++)
+    {
+        HostClock::advance(60000000ULL);
+        fired += clock.isAlarm2();
+    }
+
+    CHECK(fired == 7 * 24 * 60);
+
+    Wire.detach(DS3231_ADDRESS);
+}
+
+int main(void)
+{
+    checkWire();
+
+    return HostTest::finish("test_simulator");
+}
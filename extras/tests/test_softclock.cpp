@@ -0,0 +1,124 @@
+/*
+
+The MIT License
+
+Copyright (c) 2014-2023 Korneliusz Jarzębski
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+/*
+
+The soft clock against the seconds register of the simulator, and its
+pairing with the sub-second time from SQW.
+
+*/
+
+#include <math.h>
+
+#include "Arduino.h"
+#include "DS3231.h"
+#include "DS3231Sim.h"
+#include "HostTest.h"
+
+DS3231Sim sim;
+DS3231 rtc;
+
+void isr(void)
+{
+    rtc.handleSqw();
+}
+
+static void checkSoftClock(void)
+{
+    DS3231Sim chip;
+    DS3231 clock;
+    int worst = 0;
+
+    clock.begin(chip);
+    clock.setDateTime(2023, 5, 19, 12, 0, 0);
+    clock.enableSoftClock(60000);
+
+    for (int i = 0; i < 100000; i++)
+    {
+        RTCDateTime dt;
+        uint8_t seconds;
+        int error;
+
+        delayMicroseconds(7000);
+        dt = clock.getDateTime();
+        seconds = chip.peek(0);
+        error = (dt.second - ((seconds >> 4) * 10 + (seconds & 0b00001111)) + 60) % 60;
+
+        if (error > 30)
+        {
+            error -= 60;
+        }
+
+        if (abs(error) > abs(worst))
+        {
+            worst = error;
+        }
+    }
+
+    CHECK(abs(worst) <= 1);
+    CHECK(clock.getSoftClockHits() > clock.getSoftClockMisses());
+}
+
+static void checkSoftClockPairing(void)
+{
+    uint64_t set;
+
+    rtc.enableSoftClock(60000);
+    rtc.setDateTime(2023, 5, 19, 12, 0, 0);
+    set = HostClock::now();
+
+    // Sync the soft clock just before the chip's next seconds tick
+    delay(900);
+    rtc.getDateTime();
+    delay(2300);
+
+    for (int i = 0; i < 5; i++)
+    {
+        RTCPreciseTime p;
+        double elapsed;
+
+        delayMicroseconds(137777);
+        p = rtc.now();
+        elapsed = (HostClock::now() - set) / 1e6;
+
+        CHECK(fabs((p.unixtime - 1684497600UL) + p.micros / 1e6 - elapsed) < 0.002);
+    }
+
+    rtc.enableSoftClock(0);
+}
+
+int main(void)
+{
+    rtc.begin(sim);
+    sim.setInterruptPin(0);
+    attachInterrupt(0, isr, FALLING);
+    rtc.enablePreciseClock();
+
+    checkSoftClock();
+    checkSoftClockPairing();
+
+    return HostTest::finish("test_softclock");
+}
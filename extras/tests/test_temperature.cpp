@@ -0,0 +1,207 @@
+/*
+
+The MIT License
+
+Copyright (c) 2014-2023 Korneliusz Jarzębski
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+/*
+
+Temperature conversions: the blocking and non-blocking paths, a chip
+that is already converting and a failing bus.
+
+*/
+
+#include <string.h>
+
+#include "Arduino.h"
+#include "DS3231.h"
+#include "DS3231Sim.h"
+#include "HostTest.h"
+
+DS3231Sim sim;
+DS3231 rtc;
+
+// Passes everything to the simulator until it is told to fail, then
+// scribbles over the read buffer and reports the failure
+class FailingBus : public DS3231Bus
+{
+    public:
+
+    bool failing;
+
+    FailingBus(void) : failing(false)
+    {
+    }
+
+    virtual bool readRegisters(uint8_t address, uint8_t reg, uint8_t *values, uint8_t count)
+    {
+        if (failing)
+        {
+            memset(values, 0, count);
+            return false;
+        }
+
+        return sim.readRegisters(address, reg, values, count);
+    }
+
+    virtual bool writeRegisters(uint8_t address, uint8_t reg, const uint8_t *values, uint8_t count)
+    {
+        return !failing && sim.writeRegisters(address, reg, values, count);
+    }
+};
+
+int conversions = 0;
+
+void converted(void)
+{
+    conversions++;
+}
+
+static void checkConversion(void)
+{
+    rtc.setConversionCallback(converted);
+
+    sim.setTemperature(4 * 27 + 3);
+    rtc.forceConversion();
+    CHECK(rtc.readTemperature() == 27.75);
+    CHECK(conversions == 1);
+
+    // Start while the automatic 64 second conversion is busy
+    delay(63999 - (HostClock::now() / 1000) % 64000 + 50);
+    CHECK(sim.peek(0x0f) & 0b00000100);
+
+    sim.setTemperature(4 * 20);
+    rtc.startConversion();
+
+    while (!rtc.isConversionReady())
+    {
+        delayMicroseconds(100);
+    }
+
+    CHECK(rtc.readTemperature() == 20.0);
+    CHECK(conversions == 2);
+
+    // One read of CONTROL and STATUS, then the CONV write
+    delay(1000);
+    sim.resetCounters();
+    rtc.startConversion();
+    CHECK(sim.getTransactions() == 3);
+
+    while (!rtc.isConversionReady())
+    {
+        delayMicroseconds(100);
+    }
+
+    rtc.setConversionCallback(NULL);
+}
+
+static void checkPoll(void)
+{
+    int16_t quarters = 0;
+    int polls = 1;
+
+    sim.setTemperature(4 * 31 + 1);
+    CHECK(!rtc.pollTemperature(quarters));
+
+    while (!rtc.pollTemperature(quarters))
+    {
+        delayMicroseconds(100);
+        polls++;
+    }
+
+    CHECK(quarters == 4 * 31 + 1);
+    CHECK(polls > 1);
+
+    // The next call asks for a new conversion
+    sim.setTemperature(4 * 30);
+    CHECK(!rtc.pollTemperature(quarters));
+    delay(300);
+    CHECK(rtc.pollTemperature(quarters) && (quarters == 4 * 30));
+}
+
+static void checkFailure(void)
+{
+    FailingBus bus;
+    DS3231 clock;
+    uint32_t start;
+
+    clock.begin(bus);
+    clock.setConversionCallback(converted);
+    conversions = 0;
+
+    // A failed poll leaves the conversion outstanding
+    delay(1000);
+    clock.startConversion();
+    bus.failing = true;
+    delay(300);
+    CHECK(!clock.isConversionReady());
+    CHECK(conversions == 0);
+
+    bus.failing = false;
+    delay(20);
+    CHECK(clock.isConversionReady());
+    CHECK(conversions == 1);
+
+    // forceConversion() gives up on a dead bus
+    bus.failing = true;
+    start = millis();
+    CHECK(!clock.forceConversion());
+    CHECK((millis() - start) >= DS3231_CONVERSION_TIMEOUT);
+    CHECK((millis() - start) < DS3231_CONVERSION_TIMEOUT + 20);
+    CHECK(conversions == 1);
+
+    bus.failing = false;
+    sim.setTemperature(4 * 22 + 2);
+    CHECK(clock.forceConversion());
+    CHECK(clock.readTemperatureQuarters() == 4 * 22 + 2);
+    CHECK(conversions == 2);
+
+    // The cached copies survive a failed refresh
+    clock.enableCache(true);
+    clock.enable32kHz(true);
+    bus.failing = true;
+    CHECK(!clock.refresh());
+    CHECK(clock.isCached() && clock.is32kHz());
+
+    // and a cache that cannot be filled stays off
+    clock.enableCache(false);
+    clock.enableCache(true);
+    CHECK(!clock.isCached());
+
+    bus.failing = false;
+    clock.enableCache(true);
+    CHECK(clock.isCached() && clock.is32kHz());
+    clock.enableCache(false);
+    clock.setConversionCallback(NULL);
+}
+
+int main(void)
+{
+    rtc.begin(sim);
+
+    checkConversion();
+    checkPoll();
+    checkFailure();
+
+    return HostTest::finish("test_temperature");
+}
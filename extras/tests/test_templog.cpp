@@ -0,0 +1,128 @@
+/*
+
+The MIT License
+
+Copyright (c) 2014-2023 Korneliusz Jarzębski
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+/*
+
+The compressed temperature log over two days of simulated drift.
+
+*/
+
+#include <algorithm>
+#include <vector>
+
+#include "Arduino.h"
+#include "DS3231.h"
+#include "DS3231Sim.h"
+#include "DS3231TemperatureLog.h"
+#include "HostTest.h"
+
+DS3231Sim sim;
+DS3231 rtc;
+
+static void checkLog(void)
+{
+    uint8_t buffer[700];
+    uint8_t tiny[2];
+    DS3231TemperatureLog log(rtc, buffer, sizeof(buffer));
+    DS3231TemperatureLog small(rtc, tiny, sizeof(tiny));
+    DS3231TemperatureStats window;
+    std::vector<int16_t> all;
+    std::vector<int16_t> history;
+    int16_t quarters = 88;
+    int16_t minimum = 32767;
+    int16_t maximum = -32768;
+    int32_t sum = 0;
+    size_t start;
+
+    srand(3);
+
+    // Two days of slow drift with the odd jump
+    for (int s = 0; s < 86400 * 2; s++)
+    {
+        if ((s % 64) == 0)
+        {
+            if ((rand() % 5) == 0)
+            {
+                quarters += (rand() % 3) - 1;
+            }
+
+            if ((rand() % 2000) == 0)
+            {
+                quarters += 40;
+            }
+
+            sim.setTemperature(quarters);
+        }
+
+        delay(1000);
+
+        if (log.update())
+        {
+            all.push_back(rtc.readTemperatureQuarters());
+        }
+    }
+
+    log.rewind();
+
+    while (log.next(quarters))
+    {
+        history.push_back(quarters);
+    }
+
+    // The buffer keeps the newest readings
+    CHECK(history.size() == log.getCount());
+    CHECK(history.size() < all.size());
+    CHECK(std::equal(history.begin(), history.end(), all.end() - history.size()));
+
+    window = log.getLastWindow();
+    start = all.size() - (all.size() % 56) - 56;
+
+    for (size_t i = start; i < start + 56; i++)
+    {
+        minimum = std::min(minimum, all[i]);
+        maximum = std::max(maximum, all[i]);
+        sum += all[i];
+    }
+
+    CHECK((window.min == minimum) && (window.max == maximum) && (window.sum == sum));
+
+    for (int i = 0; i < 100; i++)
+    {
+        small.add(i * 50 - 2000);
+    }
+
+    CHECK(small.getCount() == 2);
+    CHECK(small.getLatest() == 2950);
+}
+
+int main(void)
+{
+    rtc.begin(sim);
+
+    checkLog();
+
+    return HostTest::finish("test_templog");
+}
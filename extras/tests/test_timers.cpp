@@ -0,0 +1,235 @@
+/*
+
+The MIT License
+
+Copyright (c) 2014-2023 Korneliusz Jarzębski
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+/*
+
+32 periodic timers multiplexed on alarm 1 for three simulated days.
+
+*/
+
+#include "Arduino.h"
+#include "DS3231.h"
+#include "DS3231Sim.h"
+#include "DS3231Timers.h"
+#include "HostTest.h"
+
+struct Expected
+{
+    uint32_t period;
+    uint32_t next;
+    uint32_t fires;
+    uint32_t late;
+};
+
+DS3231Sim sim;
+DS3231 rtc;
+
+DS3231Timer *heap[40];
+DS3231Timers timers(rtc, heap, 40);
+
+DS3231Timer *timer[32];
+Expected expected[32];
+
+void counted(void *context)
+{
+    ((Expected *)context)->fires++;
+}
+
+void isr(void)
+{
+    timers.handleInterrupt();
+}
+
+void fired(void *context)
+{
+    Expected *e = (Expected *)context;
+
+    if (rtc.getDateTime().unixtime != e->next)
+    {
+        e->late++;
+    }
+
+    e->fires++;
+    e->next += e->period;
+}
+
+static void checkPeriodic(void)
+{
+    uint32_t start;
+    uint32_t end;
+
+    rtc.setDateTime(2024, 2, 27, 23, 59, 0);
+    start = rtc.getDateTime().unixtime;
+
+    for (int i = 0; i < 32; i++)
+    {
+        expected[i].period = 5 + (i * 37) % 300;
+        expected[i].next = start + expected[i].period + i;
+        timer[i] = new DS3231Timer(fired, &expected[i]);
+        timers.start(*timer[i], expected[i].next, expected[i].period);
+    }
+
+    for (uint32_t i = 0; i < 3 * 86400UL * 20; i++)
+    {
+        delay(50);
+
+        if (timers.isPending())
+        {
+            timers.dispatch();
+        }
+    }
+
+    // Bus transfers advance the host clock too, so count from the chip
+    end = rtc.getDateTime().unixtime;
+
+    for (int i = 0; i < 32; i++)
+    {
+        uint32_t first = start + expected[i].period + i;
+        uint32_t due = (end - first) / expected[i].period + 1;
+
+        CHECK(expected[i].late == 0);
+        CHECK((expected[i].fires == due) || (expected[i].fires + 1 == due));
+    }
+
+    timers.stop(*timer[0]);
+    CHECK(timers.count() == 31);
+    CHECK(!timers.isActive(*timer[0]));
+}
+
+static void checkSoftClock(void)
+{
+    Expected e;
+    DS3231Timer once(fired, &e);
+
+    rtc.enableSoftClock(60000);
+    rtc.setDateTime(2024, 3, 1, 12, 0, 0);
+
+    // A soft clock synced late in the second runs behind the chip
+    delay(900);
+    e.period = 0;
+    e.next = rtc.getDateTime().unixtime + 5;
+    e.fires = 0;
+    e.late = 0;
+    timers.start(once, e.next, 0);
+
+    for (int i = 0; i < 200; i++)
+    {
+        delay(50);
+
+        if (timers.isPending())
+        {
+            timers.dispatch();
+        }
+    }
+
+    CHECK(e.fires == 1);
+    CHECK(!timers.isActive(once));
+
+    rtc.enableSoftClock(0);
+}
+
+static void checkMissed(void)
+{
+    DS3231Sim chip;
+    DS3231 clock;
+    DS3231Timer *slots[4];
+    DS3231Timers polled(clock, slots, 4);
+    Expected first = { 0, 0, 0, 0 };
+    Expected second = { 0, 0, 0, 0 };
+    DS3231Timer a(counted, &first);
+    DS3231Timer b(counted, &second);
+    uint32_t start;
+
+    // No interrupt: a deadline that passes unseen is still caught
+    clock.begin(chip);
+    clock.setDateTime(2024, 3, 1, 12, 0, 0);
+    start = clock.readDateTime().unixtime;
+
+    polled.start(a, start + 2, 0);
+    delay(3000);
+    CHECK(!polled.isPending());
+
+    polled.start(b, start + 100, 0);
+    CHECK(polled.isPending());
+    polled.dispatch();
+    CHECK((first.fires == 1) && (second.fires == 0));
+
+    // The alarm flag counts as reaching the deadline even if the clock
+    // was stepped back since
+    polled.start(a, start + 10, 0);
+    delay(8000);
+    clock.setDateTime(start + 8);
+    polled.dispatch();
+    CHECK(first.fires == 2);
+}
+
+static void checkFarDeadline(void)
+{
+    Expected e = { 0, 0, 0, 0 };
+    DS3231Timer once(fired, &e);
+    uint32_t fireTime = 0;
+
+    // Alarm 1 matches 2024-03-16 12:00 before the real deadline in April
+    rtc.setDateTime(2024, 3, 1, 12, 0, 0);
+    e.next = rtc.readDateTime().unixtime + 45 * 86400UL;
+    timers.start(once, e.next, 0);
+
+    for (uint32_t i = 0; (i < 50 * 8640UL) && !e.fires; i++)
+    {
+        HostClock::advance(10000000);
+
+        if (timers.isPending())
+        {
+            timers.dispatch();
+            fireTime = rtc.readDateTime().unixtime;
+        }
+    }
+
+    CHECK(e.fires == 1);
+    CHECK(e.late == 0);
+    CHECK((fireTime >= e.next) && (fireTime < e.next + 10));
+}
+
+int main(void)
+{
+    rtc.begin(sim);
+    rtc.enableOutput(false);
+    sim.setInterruptPin(0);
+    attachInterrupt(0, isr, FALLING);
+
+    checkPeriodic();
+
+    for (int i = 1; i < 32; i++)
+    {
+        timers.stop(*timer[i]);
+    }
+
+    checkSoftClock();
+    checkMissed();
+    checkFarDeadline();
+
+    return HostTest::finish("test_timers");
+}
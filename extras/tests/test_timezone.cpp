@@ -0,0 +1,116 @@
+/*
+
+The MIT License
+
+Copyright (c) 2014-2023 Korneliusz Jarzębski
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+/*
+
+POSIX TZ rules against the C library's localtime_r() with the same TZ
+string, plus the spring-forward gap and rejected strings.
+
+*/
+
+#include <stdlib.h>
+#include <time.h>
+
+#include "Arduino.h"
+#include "DS3231.h"
+#include "DS3231Timezone.h"
+#include "HostTest.h"
+
+static void checkZone(const char *zone)
+{
+    DS3231Timezone tz;
+    uint32_t t;
+
+    CHECK(tz.parse(zone));
+
+    setenv("TZ", zone, 1);
+    tzset();
+
+    // The C library applies pre-2007 US rules to the bare EST5EDT name
+    t = strcmp(zone, "EST5EDT") ? 946684800UL + 86400UL * 3 : 1199145600UL;
+
+    for (int i = 0; i < 400000; i++)
+    {
+        time_t seconds;
+        struct tm local;
+        uint32_t shifted;
+
+        t += rand() % 7200;
+        seconds = t;
+        localtime_r(&seconds, &local);
+        shifted = tz.toLocal(t);
+
+        CHECK((int32_t)(shifted - t) == local.tm_gmtoff);
+        CHECK(tz.isDst(t) == (local.tm_isdst > 0));
+        CHECK(!strcmp(tz.getAbbreviation(t), local.tm_zone));
+
+        // Only local times in the autumn overlap map back ambiguously
+        if (tz.toUtc(shifted) != t)
+        {
+            time_t before = t - 3 * 3600;
+            time_t after = t + 3 * 3600;
+            struct tm a;
+            struct tm b;
+
+            localtime_r(&before, &a);
+            localtime_r(&after, &b);
+            CHECK(a.tm_gmtoff != b.tm_gmtoff);
+        }
+    }
+}
+
+int main(void)
+{
+    const char *zones[] = { "CET-1CEST,M3.5.0,M10.5.0/3", "EST5EDT,M3.2.0,M11.1.0", "AEST-10AEDT,M10.1.0,M4.1.0/3",
+        "<+0530>-5:30", "NZST-12NZDT,M9.5.0,M4.1.0/3", "IST-1GMT0,M10.5.0,M3.5.0/1", "XXX3YYY,J60/1,300/25",
+        "ABC+3:30DEF+2:30,M3.5.0/-1,M10.4.6/26", "EST5EDT", "UTC0" };
+    const char *invalid[] = { "", "CE", "CET", "CET-1CEST,M3.5", "CET-1CEST,M13.1.0,M10.5.0", "<+05", "CET-25",
+        "CET-1CEST,M3.5.0,M10.5.0/3x" };
+    DS3231Timezone cet("CET-1CEST,M3.5.0,M10.5.0/3");
+    DS3231Timezone tz;
+
+    srand(5);
+
+    for (const char *zone : zones)
+    {
+        checkZone(zone);
+    }
+
+    for (const char *zone : invalid)
+    {
+        CHECK(!tz.parse(zone));
+    }
+
+    // 2024-03-31 01:00 UTC, clocks go from 02:00 to 03:00 CET
+    CHECK(cet.getNextTransition(1711846800UL - 1) == 1711846800UL);
+    CHECK(cet.toLocal(DS3231::fromEpoch(1711846800UL - 1)).hour == 1);
+    CHECK(cet.toLocal(DS3231::fromEpoch(1711846800UL)).hour == 3);
+
+    // 02:30 does not exist and resolves with the winter offset
+    CHECK(cet.toUtc(1711846800UL + 3600 + 1800) == 1711846800UL + 1800);
+
+    return HostTest::finish("test_timezone");
+}
@@ -30,16 +30,58 @@ SOFTWARE.
 #include "WProgram.h"
 #endif
 
-#include <Wire.h>
 #include "DS3231.h"
+#include "DS3231Calendar.h"
 
-const uint8_t daysArray [] PROGMEM = { 31,28,31,30,31,30,31,31,30,31,30,31 };
-const uint8_t dowArray[] PROGMEM = { 0, 3, 2, 5, 0, 3, 5, 1, 4, 6, 2, 4 };
+DS3231::DS3231(uint8_t address) : wireBus(Wire)
+{
+    bus = &wireBus;
+    this->address = address;
+    cached = false;
+    control = 0;
+    status = 0;
+
+    sqwEdges = 0;
+    sqwMicros = 0;
+    sqwPeriod = 16000000;
+    sqwSynced = false;
+
+    softInterval = 0;
+    softSynced = false;
+    softHits = 0;
+    softMisses = 0;
+
+    conversion = DS3231_CONVERSION_IDLE;
+    conversionCallback = 0;
+    temperatureRequested = false;
+
+    setLatency = 0;
+    setError = 0;
+}
 
 bool DS3231::begin(void)
 {
     Wire.begin();
 
+    return begin(wireBus);
+}
+
+bool DS3231::begin(TwoWire &wire)
+{
+    wireBus = DS3231TwoWire(wire);
+
+    return begin(wireBus);
+}
+
+bool DS3231::begin(DS3231Bus &bus)
+{
+    this->bus = &bus;
+
+    if (cached)
+    {
+        refresh();
+    }
+
     setBattery(true, false);
 
     t.year = 2000;
@@ -49,432 +91,805 @@ bool DS3231::begin(void)
     t.minute = 0;
     t.second = 0;
     t.dayOfWeek = 6;
-    t.unixtime = 946681200;
+    t.unixtime = DS3231_EPOCH;
 
     return true;
 }
 
+uint8_t DS3231::getAddress(void)
+{
+    return address;
+}
+
 void DS3231::setDateTime(uint16_t year, uint8_t month, uint8_t day, uint8_t hour, uint8_t minute, uint8_t second)
 {
-    Wire.beginTransmission(DS3231_ADDRESS);
+    uint8_t values[7];
 
-    #if ARDUINO >= 100
-        Wire.write(DS3231_REG_TIME);
-    #else
-        Wire.send(DS3231_REG_TIME);
-    #endif
+    encodeDateTime(values, year, month, day, hour, minute, second);
 
-    #if ARDUINO >= 100
-        Wire.write(dec2bcd(second));
-        Wire.write(dec2bcd(minute));
-        Wire.write(dec2bcd(hour));
-        Wire.write(dec2bcd(dow(year, month, day)));
-        Wire.write(dec2bcd(day));
-        Wire.write(dec2bcd(month));
-        Wire.write(dec2bcd(year-2000));
-    #else
-        Wire.send(dec2bcd(second));
-        Wire.send(dec2bcd(minute));
-        Wire.send(dec2bcd(hour));
-        Wire.send(dec2bcd(dow(year, month, day)));
-        Wire.send(dec2bcd(day));
-        Wire.send(dec2bcd(month));
-        Wire.send(dec2bcd(year-2000));
-    #endif
+    writeRegisters(DS3231_REG_TIME, values, 7);
 
-    Wire.endTransmission();
+    sqwSynced = false;
+    softSynced = false;
 }
 
 void DS3231::setDateTime(uint32_t t)
 {
-    t -= 946681200;
+    RTCDateTime dt = loadDateTimeFromLong(t);
+
+    setDateTime(dt.year, dt.month, dt.day, dt.hour, dt.minute, dt.second);
+}
+
+// The seconds since 2000 are taken modulo 2^32, so wrapped unixtimes past
+// 2106 still load correctly up to 2136. Use fromEpoch() beyond that.
+RTCDateTime DS3231::loadDateTimeFromLong(uint32_t t)
+{
+    t -= DS3231_EPOCH;
+
+    return fromDays(t / 86400, t % 86400);
+}
+
+// Seconds since 1970 without the 2106 limit of RTCDateTime::unixtime
+int64_t DS3231::toEpoch(const RTCDateTime &dt)
+{
+    return (int64_t)date2days(dt.year, dt.month, dt.day) * 86400 + time2long(0, dt.hour, dt.minute, dt.second) + DS3231_EPOCH;
+}
+
+// Valid from 2000 to 2199, earlier times give 2000-01-01 00:00:00 and later
+// ones 2199-12-31 23:59:59
+RTCDateTime DS3231::fromEpoch(int64_t t)
+{
+    t -= DS3231_EPOCH;
+
+    if (t < 0)
+    {
+        t = 0;
+    } else if (t >= 73049LL * 86400)
+    {
+        t = 73049LL * 86400 - 1;
+    }
+
+    return fromDays((uint32_t)(t / 86400), (uint32_t)(t % 86400));
+}
+
+// Results saturate at the ends of 2000-2199 like fromEpoch()
+RTCDateTime DS3231::addSeconds(const RTCDateTime &dt, int32_t seconds)
+{
+    int32_t days = seconds / 86400;
+    int32_t rest = (int32_t)time2long(0, dt.hour, dt.minute, dt.second) + seconds % 86400;
+
+    if (rest < 0)
+    {
+        rest += 86400;
+        --days;
+    } else if (rest >= 86400)
+    {
+        rest -= 86400;
+        ++days;
+    }
+
+    return moveDays(date2days(dt.year, dt.month, dt.day), days, rest);
+}
+
+RTCDateTime DS3231::addDays(const RTCDateTime &dt, int32_t days)
+{
+    return moveDays(date2days(dt.year, dt.month, dt.day), days, time2long(0, dt.hour, dt.minute, dt.second));
+}
 
+// The day is clamped to the length of the target month, so January 31st
+// plus one month is the last day of February
+RTCDateTime DS3231::addMonths(const RTCDateTime &dt, int16_t months)
+{
+    int32_t index = (int32_t)(dt.year - 2000) * 12 + (dt.month - 1) + months;
     uint16_t year;
     uint8_t month;
     uint8_t day;
-    uint8_t hour;
-    uint8_t minute;
-    uint8_t second;
 
-    second = t % 60;
-    t /= 60;
+    if (index < 0)
+    {
+        index = 0;
+    } else if (index > 200 * 12 - 1)
+    {
+        index = 200 * 12 - 1;
+    }
+
+    year = 2000 + index / 12;
+    month = index % 12 + 1;
+    day = dt.day;
+
+    if (day > daysInMonth(year, month))
+    {
+        day = daysInMonth(year, month);
+    }
+
+    return fromDays(date2days(year, month, day), time2long(0, dt.hour, dt.minute, dt.second));
+}
+
+// Seconds from b to a
+int64_t DS3231::diff(const RTCDateTime &a, const RTCDateTime &b)
+{
+    int32_t days = (int32_t)date2days(a.year, a.month, a.day) - (int32_t)date2days(b.year, b.month, b.day);
+    int32_t seconds = (int32_t)time2long(0, a.hour, a.minute, a.second) - (int32_t)time2long(0, b.hour, b.minute, b.second);
+
+    return (int64_t)days * 86400 + seconds;
+}
 
-    minute = t % 60;
-    t /= 60;
+// Negative, zero or positive as a is before, equal to or after b
+int8_t DS3231::compare(const RTCDateTime &a, const RTCDateTime &b)
+{
+    if (a.year != b.year)
+    {
+        return (a.year < b.year) ? -1 : 1;
+    }
 
-    hour = t % 24;
-    uint16_t days = t / 24;
-    uint8_t leap;
+    if (a.month != b.month)
+    {
+        return (a.month < b.month) ? -1 : 1;
+    }
 
-    for (year = 0; ; ++year)
+    if (a.day != b.day)
     {
-        leap = year % 4 == 0;
-        if (days < 365 + leap)
-        {
-            break;
-        }
-        days -= 365 + leap;
+        return (a.day < b.day) ? -1 : 1;
+    }
+
+    if (a.hour != b.hour)
+    {
+        return (a.hour < b.hour) ? -1 : 1;
+    }
+
+    if (a.minute != b.minute)
+    {
+        return (a.minute < b.minute) ? -1 : 1;
     }
 
-    for (month = 1; ; ++month)
+    if (a.second != b.second)
+    {
+        return (a.second < b.second) ? -1 : 1;
+    }
+
+    return 0;
+}
+
+// Days before 2000-01-01 give its midnight, days after 2199-12-31 its
+// last second
+RTCDateTime DS3231::moveDays(uint32_t base, int32_t days, uint32_t seconds)
+{
+    if (days < -(int32_t)base)
+    {
+        return fromDays(0, 0);
+    }
+
+    if (days >= 73049 - (int32_t)base)
+    {
+        return fromDays(73048, 86399);
+    }
+
+    return fromDays(base + days, seconds);
+}
+
+RTCDateTime DS3231::fromDays(uint32_t days, uint32_t seconds)
+{
+    RTCDateTime dt;
+
+    dt.second = seconds % 60;
+    seconds /= 60;
+
+    dt.minute = seconds % 60;
+    dt.hour = seconds / 60;
+
+    days2date(days, dt);
+
+    dt.unixtime = days * 86400UL + time2long(0, dt.hour, dt.minute, dt.second) + DS3231_EPOCH;
+
+    return dt;
+}
+
+void DS3231::setDateTime(const RTCDateTime &dt)
+{
+    setDateTime(dt.year, dt.month, dt.day, dt.hour, dt.minute, dt.second);
+}
+
+// Nothing is written when date or time is malformed
+bool DS3231::setDateTime(const char* date, const char* time)
+{
+    RTCDateTime dt;
+
+    if (!parseDateTime(date, time, dt))
     {
-        uint8_t daysPerMonth = pgm_read_byte(daysArray + month - 1);
+        return false;
+    }
+
+    setDateTime(dt);
+
+    return true;
+}
 
-        if (leap && month == 2)
+// __DATE__ and __TIME__ layout, "Mmm dd yyyy" and "hh:mm:ss"
+bool DS3231::parseDateTime(const char *date, const char *time, RTCDateTime &dt)
+{
+    uint16_t year;
+    uint16_t day;
+    uint16_t hour;
+    uint16_t minute;
+    uint16_t second;
+    uint8_t month = 0;
+
+    for (uint8_t i = 0; (i < 12) && (month == 0); ++i)
+    {
+        if (!strncmp(date, DS3231Calendar::monthName(i + 1), 3))
         {
-            ++daysPerMonth;
+            month = i + 1;
         }
+    }
+
+    if ((month == 0) || (date[3] != ' '))
+    {
+        return false;
+    }
 
-        if (days < daysPerMonth)
+    date += 4;
+
+    // Days below 10 are padded with a space
+    if (*date == ' ')
+    {
+        ++date;
+
+        if (!parseDigits(date, 1, day))
         {
-            break;
+            return false;
         }
-        days -= daysPerMonth;
+    } else if (!parseDigits(date, 2, day))
+    {
+        return false;
+    }
+
+    if ((*date++ != ' ') || !parseDigits(date, 4, year) || (*date != '\0'))
+    {
+        return false;
     }
 
-    day = days + 1;
+    if (!parseDigits(time, 2, hour) || (*time++ != ':') || !parseDigits(time, 2, minute) ||
+        (*time++ != ':') || !parseDigits(time, 2, second) || (*time != '\0'))
+    {
+        return false;
+    }
 
-    setDateTime(year+2000, month, day, hour, minute, second);
+    return makeDateTime(year, month, day, hour, minute, second, 0, dt);
 }
 
+// YYYY-MM-DD with optional [T ]hh:mm[:ss[.fff]][Z|+hh[[:]mm]], without an
+// offset the time is taken as is
+bool DS3231::parseIso8601(const char *str, RTCDateTime &dt)
+{
+    return parseIso(str, false, dt);
+}
 
-RTCDateTime DS3231::loadDateTimeFromLong(uint32_t t)
+// YYYY-MM-DDThh:mm:ss[.fff](Z|+hh:mm), the offset is required
+bool DS3231::parseRfc3339(const char *str, RTCDateTime &dt)
 {
-    t -= 946681200;
+    return parseIso(str, true, dt);
+}
 
+// Single pass over str, the result is converted to UTC when an offset is
+// given. Fractions of a second are dropped.
+bool DS3231::parseIso(const char *p, bool strict, RTCDateTime &dt)
+{
     uint16_t year;
-    uint8_t month;
-    uint8_t day;
-    uint8_t hour;
-    uint8_t minute;
-    uint8_t second;
+    uint16_t month;
+    uint16_t day;
+    uint16_t hour = 0;
+    uint16_t minute = 0;
+    uint16_t second = 0;
+    uint16_t offsetHour;
+    uint16_t offsetMinute = 0;
+    int32_t offset = 0;
+
+    if (!parseDigits(p, 4, year) || (*p++ != '-') || !parseDigits(p, 2, month) ||
+        (*p++ != '-') || !parseDigits(p, 2, day))
+    {
+        return false;
+    }
+
+    if (*p != '\0')
+    {
+        if ((*p != 'T') && (*p != 't') && (*p != ' '))
+        {
+            return false;
+        }
+
+        ++p;
+
+        if (!parseDigits(p, 2, hour) || (*p++ != ':') || !parseDigits(p, 2, minute))
+        {
+            return false;
+        }
+
+        if (*p == ':')
+        {
+            ++p;
+
+            if (!parseDigits(p, 2, second))
+            {
+                return false;
+            }
+        } else if (strict)
+        {
+            return false;
+        }
+
+        if ((*p == '.') || (!strict && (*p == ',')))
+        {
+            ++p;
+
+            if ((*p < '0') || (*p > '9'))
+            {
+                return false;
+            }
+
+            while ((*p >= '0') && (*p <= '9'))
+            {
+                ++p;
+            }
+        }
+
+        if ((*p == 'Z') || (*p == 'z'))
+        {
+            ++p;
+        } else if ((*p == '+') || (*p == '-'))
+        {
+            bool negative = (*p++ == '-');
+
+            if (!parseDigits(p, 2, offsetHour) || (offsetHour > 23))
+            {
+                return false;
+            }
+
+            if (*p == ':')
+            {
+                ++p;
+
+                if (!parseDigits(p, 2, offsetMinute))
+                {
+                    return false;
+                }
+            } else if (strict)
+            {
+                return false;
+            } else if ((*p >= '0') && (*p <= '9') && !parseDigits(p, 2, offsetMinute))
+            {
+                return false;
+            }
+
+            if (offsetMinute > 59)
+            {
+                return false;
+            }
+
+            offset = (int32_t)offsetHour * 3600 + offsetMinute * 60;
+
+            if (negative)
+            {
+                offset = -offset;
+            }
+        } else if (strict)
+        {
+            return false;
+        }
+    } else if (strict)
+    {
+        return false;
+    }
 
-    second = t % 60;
-    t /= 60;
+    if (*p != '\0')
+    {
+        return false;
+    }
 
-    minute = t % 60;
-    t /= 60;
+    return makeDateTime(year, month, day, hour, minute, second, offset, dt);
+}
 
-    hour = t % 24;
-    uint16_t days = t / 24;
-    uint8_t leap;
+bool DS3231::parseDigits(const char *&p, uint8_t count, uint16_t &value)
+{
+    value = 0;
 
-    for (year = 0; ; ++year)
+    while (count--)
     {
-        leap = year % 4 == 0;
-        if (days < 365 + leap)
+        if ((*p < '0') || (*p > '9'))
         {
-            break;
+            return false;
         }
-        days -= 365 + leap;
+
+        value = value * 10 + (*p++ - '0');
+    }
+
+    return true;
+}
+
+// Validates the fields and fills dt, shifted back by offset seconds
+bool DS3231::makeDateTime(uint16_t year, uint8_t month, uint8_t day, uint8_t hour, uint8_t minute, uint8_t second, int32_t offset, RTCDateTime &dt)
+{
+    int64_t t;
+
+    if ((year < 2000) || (year > 2199) || (month < 1) || (month > 12) ||
+        (day < 1) || (day > daysInMonth(year, month)) ||
+        (hour > 23) || (minute > 59) || (second > 59))
+    {
+        return false;
+    }
+
+    if (offset == 0)
+    {
+        dt = fromDays(date2days(year, month, day), time2long(0, hour, minute, second));
+
+        return true;
     }
 
-    for (month = 1; ; ++month)
+    t = (int64_t)date2days(year, month, day) * 86400 + time2long(0, hour, minute, second) - offset;
+
+    if ((t < 0) || (t >= 73049LL * 86400))
     {
-        uint8_t daysPerMonth = pgm_read_byte(daysArray + month - 1);
+        return false;
+    }
 
-        if (leap && month == 2)
+    dt = fromDays((uint32_t)(t / 86400), (uint32_t)(t % 86400));
+
+    return true;
+}
+
+// Appends to a caller-supplied buffer, always leaving it NUL terminated.
+// Output that does not fit is dropped.
+struct DS3231BufferSink
+{
+    DS3231BufferSink(char *out, size_t len) : p(out), end(out + (len ? len - 1 : 0))
+    {
+        if (len)
         {
-            ++daysPerMonth;
+            *p = '\0';
         }
+    }
 
-        if (days < daysPerMonth)
+    void write(char c)
+    {
+        if (p < end)
         {
-            break;
+            *p++ = c;
+            *p = '\0';
         }
-        days -= daysPerMonth;
     }
 
-    day = days + 1;
+    char *p;
+    char *end;
+};
+
+// Writes straight to a Print, counting what it accepted.
+struct DS3231PrintSink
+{
+    DS3231PrintSink(Print &print) : print(&print), count(0)
+    {
+    }
+
+    void write(char c)
+    {
+        count += print->write((uint8_t)c);
+    }
+
+    Print *print;
+    size_t count;
+};
 
-    RTCDateTime temp;
-    temp.year = year+2000;
-    temp.month = month;
-    temp.day = day;
-    temp.hour = hour;
-    temp.minute = minute;
-    temp.second = second;
+static char dateBuffer[255];
 
-    return temp;
+template <class Sink>
+static void writeString(Sink &sink, const char *s, uint8_t max = 255)
+{
+    while (*s && max--)
+    {
+        sink.write(*s++);
+    }
 }
 
-void DS3231::setDateTime(const char* date, const char* time)
+template <class Sink>
+static void writeNumber(Sink &sink, uint32_t value, uint8_t width = 1)
 {
-    uint16_t year;
-    uint8_t month;
-    uint8_t day;
-    uint8_t hour;
-    uint8_t minute;
-    uint8_t second;
+    char digits[10];
+    uint8_t count = 0;
 
-    year = conv2d(date + 9);
+    do
+    {
+        digits[count++] = '0' + (value % 10);
+        value /= 10;
+    } while (value);
 
-    switch (date[0])
+    while (width > count)
     {
-        case 'J': month = date[1] == 'a' ? 1 : month = date[2] == 'n' ? 6 : 7; break;
-        case 'F': month = 2; break;
-        case 'A': month = date[2] == 'r' ? 4 : 8; break;
-        case 'M': month = date[2] == 'r' ? 3 : 5; break;
-        case 'S': month = 9; break;
-        case 'O': month = 10; break;
-        case 'N': month = 11; break;
-        case 'D': month = 12; break;
+        sink.write('0');
+        --width;
     }
 
-    day = conv2d(date + 4);
-    hour = conv2d(time);
-    minute = conv2d(time + 3);
-    second = conv2d(time + 6);
-
-    setDateTime(year+2000, month, day, hour, minute, second);
+    while (count)
+    {
+        sink.write(digits[--count]);
+    }
 }
 
-char* DS3231::dateFormat(const char* dateFormat, RTCDateTime dt)
+// Alarm formats print the alarm day for the day of week specifiers too
+static RTCDateTime alarmDateTime(const RTCAlarmTime &dt)
 {
-    static char buffer[255];
+    RTCDateTime t;
 
-    buffer[0] = 0;
+    t.day = dt.day;
+    t.dayOfWeek = dt.day;
+    t.hour = dt.hour;
+    t.minute = dt.minute;
+    t.second = dt.second;
 
-    char helper[11];
+    return t;
+}
 
+// Alarm times only carry day, hour, minute and second, so the date
+// specifiers are copied through literally for them.
+template <class Sink>
+void DS3231::format(Sink &sink, const char *dateFormat, const RTCDateTime &dt, bool alarm)
+{
     while (*dateFormat != '\0')
     {
-        switch (dateFormat[0])
+        char c = *dateFormat++;
+
+        if (alarm && strchr("zmnFMtYyLU", c))
+        {
+            sink.write(c);
+            continue;
+        }
+
+        switch (c)
         {
             // Day decoder
             case 'd':
-                sprintf(helper, "%02d", dt.day); 
-                strcat(buffer, (const char *)helper); 
+                writeNumber(sink, dt.day, 2);
                 break;
             case 'j':
-                sprintf(helper, "%d", dt.day);
-                strcat(buffer, (const char *)helper);
+                writeNumber(sink, dt.day);
                 break;
             case 'l':
-                strcat(buffer, (const char *)strDayOfWeek(dt.dayOfWeek));
+                writeString(sink, DS3231Calendar::dayName(dt.dayOfWeek));
                 break;
             case 'D':
-                strncat(buffer, strDayOfWeek(dt.dayOfWeek), 3);
+                writeString(sink, DS3231Calendar::dayName(dt.dayOfWeek), 3);
                 break;
             case 'N':
-                sprintf(helper, "%d", dt.dayOfWeek);
-                strcat(buffer, (const char *)helper);
+                writeNumber(sink, dt.dayOfWeek);
                 break;
             case 'w':
-                sprintf(helper, "%d", (dt.dayOfWeek + 7) % 7);
-                strcat(buffer, (const char *)helper);
+                writeNumber(sink, (dt.dayOfWeek + 7) % 7);
                 break;
             case 'z':
-                sprintf(helper, "%d", dayInYear(dt.year, dt.month, dt.day));
-                strcat(buffer, (const char *)helper);
+                writeNumber(sink, DS3231Calendar::dayInYear(dt.year, dt.month, dt.day));
                 break;
             case 'S':
-                strcat(buffer, (const char *)strDaySufix(dt.day));
+                writeString(sink, DS3231Calendar::daySuffix(dt.day));
                 break;
 
             // Month decoder
             case 'm':
-                sprintf(helper, "%02d", dt.month);
-                strcat(buffer, (const char *)helper);
+                writeNumber(sink, dt.month, 2);
                 break;
             case 'n':
-                sprintf(helper, "%d", dt.month);
-                strcat(buffer, (const char *)helper);
+                writeNumber(sink, dt.month);
                 break;
             case 'F':
-                strcat(buffer, (const char *)strMonth(dt.month));
+                writeString(sink, DS3231Calendar::monthName(dt.month));
                 break;
             case 'M':
-                strncat(buffer, (const char *)strMonth(dt.month), 3);
+                writeString(sink, DS3231Calendar::monthName(dt.month), 3);
                 break;
             case 't':
-                sprintf(helper, "%d", daysInMonth(dt.year, dt.month));
-                strcat(buffer, (const char *)helper);
+                writeNumber(sink, daysInMonth(dt.year, dt.month));
                 break;
 
             // Year decoder
             case 'Y':
-                sprintf(helper, "%d", dt.year); 
-                strcat(buffer, (const char *)helper); 
+                writeNumber(sink, dt.year);
                 break;
-            case 'y': sprintf(helper, "%02d", dt.year-2000);
-                strcat(buffer, (const char *)helper);
+            case 'y':
+                writeNumber(sink, dt.year % 100, 2);
                 break;
             case 'L':
-                sprintf(helper, "%d", isLeapYear(dt.year)); 
-                strcat(buffer, (const char *)helper); 
+                writeNumber(sink, isLeapYear(dt.year));
                 break;
 
             // Hour decoder
             case 'H':
-                sprintf(helper, "%02d", dt.hour);
-                strcat(buffer, (const char *)helper);
+                writeNumber(sink, dt.hour, 2);
                 break;
             case 'G':
-                sprintf(helper, "%d", dt.hour);
-                strcat(buffer, (const char *)helper);
+                writeNumber(sink, dt.hour);
                 break;
             case 'h':
-                sprintf(helper, "%02d", hour12(dt.hour));
-                strcat(buffer, (const char *)helper);
+                writeNumber(sink, DS3231Calendar::hour12(dt.hour), 2);
                 break;
             case 'g':
-                sprintf(helper, "%d", hour12(dt.hour));
-                strcat(buffer, (const char *)helper);
+                writeNumber(sink, DS3231Calendar::hour12(dt.hour));
                 break;
             case 'A':
-                strcat(buffer, (const char *)strAmPm(dt.hour, true));
+                writeString(sink, DS3231Calendar::amPm(dt.hour, true));
                 break;
             case 'a':
-                strcat(buffer, (const char *)strAmPm(dt.hour, false));
+                writeString(sink, DS3231Calendar::amPm(dt.hour, false));
                 break;
 
             // Minute decoder
-            case 'i': 
-                sprintf(helper, "%02d", dt.minute);
-                strcat(buffer, (const char *)helper);
+            case 'i':
+                writeNumber(sink, dt.minute, 2);
                 break;
 
             // Second decoder
             case 's':
-                sprintf(helper, "%02d", dt.second); 
-                strcat(buffer, (const char *)helper); 
+                writeNumber(sink, dt.second, 2);
                 break;
 
             // Misc decoder
-            case 'U': 
-                sprintf(helper, "%lu", dt.unixtime);
-                strcat(buffer, (const char *)helper);
+            case 'U':
+                writeNumber(sink, dt.unixtime);
                 break;
 
-            default: 
-                strncat(buffer, dateFormat, 1);
+            default:
+                sink.write(c);
                 break;
         }
-        dateFormat++;
     }
+}
+
+size_t DS3231::dateFormat(char *out, size_t len, const char* dateFormat, const RTCDateTime &dt)
+{
+    DS3231BufferSink sink(out, len);
+
+    format(sink, dateFormat, dt, false);
+
+    return sink.p - out;
+}
+
+size_t DS3231::dateFormat(char *out, size_t len, const char* dateFormat, const RTCAlarmTime &dt)
+{
+    DS3231BufferSink sink(out, len);
+
+    format(sink, dateFormat, alarmDateTime(dt), true);
+
+    return sink.p - out;
+}
+
+size_t DS3231::dateFormat(Print &print, const char* dateFormat, const RTCDateTime &dt)
+{
+    DS3231PrintSink sink(print);
+
+    format(sink, dateFormat, dt, false);
+
+    return sink.count;
+}
+
+size_t DS3231::dateFormat(Print &print, const char* dateFormat, const RTCAlarmTime &dt)
+{
+    DS3231PrintSink sink(print);
+
+    format(sink, dateFormat, alarmDateTime(dt), true);
+
+    return sink.count;
+}
 
-    return buffer;
+char* DS3231::dateFormat(const char* dateFormat, RTCDateTime dt)
+{
+    this->dateFormat(dateBuffer, sizeof(dateBuffer), dateFormat, dt);
+
+    return dateBuffer;
 }
 
 char* DS3231::dateFormat(const char* dateFormat, RTCAlarmTime dt)
 {
-    static char buffer[255];
+    this->dateFormat(dateBuffer, sizeof(dateBuffer), dateFormat, dt);
 
-    buffer[0] = 0;
+    return dateBuffer;
+}
 
-    char helper[11];
+RTCDateTime DS3231::getDateTime(void)
+{
+    uint32_t elapsed = 0;
+    int32_t error;
 
-    while (*dateFormat != '\0')
+    if (softInterval)
     {
-        switch (dateFormat[0])
+        elapsed = millis() - softMillis;
+
+        if (softSynced && (elapsed < softLimit))
         {
-            // Day decoder
-            case 'd':
-                sprintf(helper, "%02d", dt.day); 
-                strcat(buffer, (const char *)helper); 
-                break;
-            case 'j':
-                sprintf(helper, "%d", dt.day);
-                strcat(buffer, (const char *)helper);
-                break;
-            case 'l':
-                strcat(buffer, (const char *)strDayOfWeek(dt.day));
-                break;
-            case 'D':
-                strncat(buffer, strDayOfWeek(dt.day), 3);
-                break;
-            case 'N':
-                sprintf(helper, "%d", dt.day);
-                strcat(buffer, (const char *)helper);
-                break;
-            case 'w':
-                sprintf(helper, "%d", (dt.day + 7) % 7);
-                strcat(buffer, (const char *)helper);
-                break;
-            case 'S':
-                strcat(buffer, (const char *)strDaySufix(dt.day));
-                break;
+            softHits++;
 
-            // Hour decoder
-            case 'H':
-                sprintf(helper, "%02d", dt.hour);
-                strcat(buffer, (const char *)helper);
-                break;
-            case 'G':
-                sprintf(helper, "%d", dt.hour);
-                strcat(buffer, (const char *)helper);
-                break;
-            case 'h':
-                sprintf(helper, "%02d", hour12(dt.hour));
-                strcat(buffer, (const char *)helper);
-                break;
-            case 'g':
-                sprintf(helper, "%d", hour12(dt.hour));
-                strcat(buffer, (const char *)helper);
-                break;
-            case 'A':
-                strcat(buffer, (const char *)strAmPm(dt.hour, true));
-                break;
-            case 'a':
-                strcat(buffer, (const char *)strAmPm(dt.hour, false));
-                break;
+            t = loadDateTimeFromLong(softUnixtime + elapsed / 1000);
 
-            // Minute decoder
-            case 'i': 
-                sprintf(helper, "%02d", dt.minute);
-                strcat(buffer, (const char *)helper);
-                break;
+            return t;
+        }
+    }
 
-            // Second decoder
-            case 's':
-                sprintf(helper, "%02d", dt.second); 
-                strcat(buffer, (const char *)helper); 
-                break;
+    t = readDateTime();
 
-            default: 
-                strncat(buffer, dateFormat, 1);
-                break;
+    if (softInterval)
+    {
+        softMisses++;
+
+        if (softSynced)
+        {
+            // One second is the phase uncertainty, anything above is MCU drift
+            error = (int32_t)(t.unixtime - (softUnixtime + elapsed / 1000));
+
+            if ((error > 1) || (error < -1))
+            {
+                softLimit = (softLimit > 2000) ? (softLimit / 2) : 1000;
+            } else if (softLimit < softInterval)
+            {
+                softLimit = (softLimit < softInterval / 2) ? (softLimit * 2) : softInterval;
+            }
         }
-        dateFormat++;
+
+        softUnixtime = t.unixtime;
+        softMillis = millis();
+        softSynced = true;
     }
 
-    return buffer;
+    return t;
 }
 
-RTCDateTime DS3231::getDateTime(void)
+// Always reads the chip. The soft clock is anchored when it syncs, not on
+// the seconds tick, so it may run up to a second behind; code that pairs
+// the time with SQW edges or alarms must use this instead.
+RTCDateTime DS3231::readDateTime(void)
 {
-    int values[7];
+    RTCDateTime dt = t;
 
-    Wire.beginTransmission(DS3231_ADDRESS);
-    #if ARDUINO >= 100
-        Wire.write(DS3231_REG_TIME);
-    #else
-        Wire.send(DS3231_REG_TIME);
-    #endif
-    Wire.endTransmission();
+    readDateTime(dt);
+
+    return dt;
+}
 
-    Wire.requestFrom(DS3231_ADDRESS, 7);
+// Returns false, leaving dt alone, if the chip did not answer
+bool DS3231::readDateTime(RTCDateTime &dt)
+{
+    uint8_t values[7];
 
-    for (int i = 6; i >= 0; i--)
+    if (!readRegisters(DS3231_REG_TIME, values, 7))
     {
-        #if ARDUINO >= 100
-            values[i] = bcd2dec(Wire.read());
-        #else
-            values[i] = bcd2dec(Wire.receive());
-        #endif
+        return false;
     }
 
-    t.year = values[0] + 2000;
-    t.month = values[1];
-    t.day = values[2];
-    t.dayOfWeek = values[3];
-    t.hour = values[4];
-    t.minute = values[5];
-    t.second = values[6];
-    t.unixtime = unixtime();
+    dt = decodeDateTime(values);
 
-    return t;
+    // The chip counts 2100 as a leap year. Catching its February 29th moves
+    // it on to March 1st, otherwise it stays a day behind from then on.
+    if ((dt.year == 2100) && (dt.month == 2) && (dt.day == 29))
+    {
+        values[3] = dec2bcd(dow(2100, 3, 1));
+        values[4] = dec2bcd(1);
+        values[5] = dec2bcd(3) | 0b10000000;
+
+        writeRegisters(DS3231_REG_TIME + 3, values + 3, 3);
+
+        dt = decodeDateTime(values);
+    }
+
+    return true;
+}
+
+bool DS3231::readSnapshot(DS3231Snapshot &snapshot)
+{
+    if (!readRegisters(DS3231_REG_TIME, snapshot.values, DS3231_SNAPSHOT_SIZE))
+    {
+        return false;
+    }
+
+    snapshot.decoded = false;
+
+    // The snapshot is as fresh as refresh() would be
+    control = snapshot.values[DS3231_REG_CONTROL] & 0b11011111;
+    status = snapshot.values[DS3231_REG_STATUS];
+
+    return true;
 }
 
 uint8_t DS3231::isReady(void) 
@@ -486,19 +901,19 @@ void DS3231::enableOutput(bool enabled)
 {
     uint8_t value;
 
-    value = readRegister8(DS3231_REG_CONTROL);
+    value = readControl();
 
     value &= 0b11111011;
     value |= (!enabled << 2);
 
-    writeRegister8(DS3231_REG_CONTROL, value);
+    writeControl(value);
 }
 
 void DS3231::setBattery(bool timeBattery, bool squareBattery)
 {
     uint8_t value;
 
-    value = readRegister8(DS3231_REG_CONTROL);
+    value = readControl();
 
     if (squareBattery)
     {
@@ -516,14 +931,26 @@ void DS3231::setBattery(bool timeBattery, bool squareBattery)
         value |= 0b10000000;
     }
 
-    writeRegister8(DS3231_REG_CONTROL, value);
+    writeControl(value);
+}
+
+// Each step is about 0.1 ppm at 25 C, positive values slow the clock down.
+// The new offset is used from the next temperature conversion on.
+void DS3231::setAging(int8_t offset)
+{
+    writeRegister8(DS3231_REG_AGING, (uint8_t)offset);
+}
+
+int8_t DS3231::getAging(void)
+{
+    return (int8_t)readRegister8(DS3231_REG_AGING);
 }
 
 bool DS3231::isOutput(void)
 {
     uint8_t value;
 
-    value = readRegister8(DS3231_REG_CONTROL);
+    value = readControl();
 
     value &= 0b00000100;
     value >>= 2;
@@ -535,19 +962,19 @@ void DS3231::setOutput(DS3231_sqw_t mode)
 {
     uint8_t value;
 
-    value = readRegister8(DS3231_REG_CONTROL);
+    value = readControl();
 
     value &= 0b11100111;
     value |= (mode << 3);
 
-    writeRegister8(DS3231_REG_CONTROL, value);
+    writeControl(value);
 }
 
 DS3231_sqw_t DS3231::getOutput(void)
 {
     uint8_t value;
 
-    value = readRegister8(DS3231_REG_CONTROL);
+    value = readControl();
 
     value &= 0b00011000;
     value >>= 3;
@@ -559,19 +986,20 @@ void DS3231::enable32kHz(bool enabled)
 {
     uint8_t value;
 
-    value = readRegister8(DS3231_REG_STATUS);
+    value = readStatus();
 
     value &= 0b11110111;
     value |= (enabled << 3);
+    value |= 0b10000011;
 
-    writeRegister8(DS3231_REG_STATUS, value);
+    writeStatus(value);
 }
 
 bool DS3231::is32kHz(void)
 {
     uint8_t value;
 
-    value = readRegister8(DS3231_REG_STATUS);
+    value = readStatus();
 
     value &= 0b00001000;
     value >>= 3;
@@ -579,203 +1007,182 @@ bool DS3231::is32kHz(void)
     return value;
 }
 
-void DS3231::forceConversion(void)
+// Blocks until the conversion finished. Gives up after
+// DS3231_CONVERSION_TIMEOUT ms, twice the longest conversion plus margin,
+// so a dead bus returns false instead of hanging.
+bool DS3231::forceConversion(void)
 {
-    uint8_t value;
+    uint32_t start = millis();
 
-    value = readRegister8(DS3231_REG_CONTROL);
+    startConversion();
 
-    value |= 0b00100000;
+    while (!isConversionReady())
+    {
+        if ((millis() - start) >= DS3231_CONVERSION_TIMEOUT)
+        {
+            conversion = DS3231_CONVERSION_IDLE;
 
-    writeRegister8(DS3231_REG_CONTROL, value);
+            return false;
+        }
+    }
 
-    do {} while ((readRegister8(DS3231_REG_CONTROL) & 0b00100000) != 0);
+    return true;
 }
 
-float DS3231::readTemperature(void)
+void DS3231::startConversion(void)
 {
-    uint8_t msb, lsb;
+    if (conversion != DS3231_CONVERSION_IDLE)
+    {
+        return;
+    }
 
-    Wire.beginTransmission(DS3231_ADDRESS);
-    #if ARDUINO >= 100
-        Wire.write(DS3231_REG_TEMPERATURE);
-    #else
-        Wire.send(DS3231_REG_TEMPERATURE);
-    #endif
-    Wire.endTransmission();
+    conversion = DS3231_CONVERSION_WAITING;
+    conversionPoll = millis();
 
-    Wire.requestFrom(DS3231_ADDRESS, 2);
+    pollConversion();
+}
 
-    #if ARDUINO >= 100
-    msb = Wire.read();
-    lsb = Wire.read();
-    #else
-    msb = Wire.receive();
-    lsb = Wire.receive();
-    #endif
+// Returns true when no conversion is outstanding. The chip is polled at
+// most every DS3231_CONVERSION_POLL ms, the conversion takes up to 200 ms.
+bool DS3231::isConversionReady(void)
+{
+    if (conversion == DS3231_CONVERSION_IDLE)
+    {
+        return true;
+    }
+
+    if ((millis() - conversionPoll) < DS3231_CONVERSION_POLL)
+    {
+        return false;
+    }
 
-    return ((((short)msb << 8) | (short)lsb) >> 6) / 4.0f;
+    conversionPoll = millis();
+
+    return pollConversion();
 }
 
-RTCAlarmTime DS3231::getAlarm1(void)
+void DS3231::setConversionCallback(void (*callback)(void))
 {
-    uint8_t values[4];
-    RTCAlarmTime a;
-
-    Wire.beginTransmission(DS3231_ADDRESS);
-    #if ARDUINO >= 100
-        Wire.write(DS3231_REG_ALARM_1);
-    #else
-        Wire.send(DS3231_REG_ALARM_1);
-    #endif
-    Wire.endTransmission();
+    conversionCallback = callback;
+}
 
-    Wire.requestFrom(DS3231_ADDRESS, 4);
+bool DS3231::pollConversion(void)
+{
+    uint8_t values[2];
 
-    for (int i = 3; i >= 0; i--)
+    // A failed read says nothing, try again on the next poll
+    if (!readRegisters(DS3231_REG_CONTROL, values, 2))
     {
-        #if ARDUINO >= 100
-            values[i] = bcd2dec(Wire.read() & 0b01111111);
-        #else
-            values[i] = bcd2dec(Wire.receive() & 0b01111111);
-        #endif
+        return false;
     }
 
-    a.day = values[0];
-    a.hour = values[1];
-    a.minute = values[2];
-    a.second = values[3];
+    control = values[0] & 0b11011111;
+    status = values[1];
 
-    return a;
-}
+    if (conversion == DS3231_CONVERSION_WAITING)
+    {
+        // A conversion started by the chip itself must finish first
+        if (!(values[1] & 0b00000100))
+        {
+            writeControl(values[0] | 0b00100000);
+            conversion = DS3231_CONVERSION_RUNNING;
+        }
 
-DS3231_alarm1_t DS3231::getAlarmType1(void)
-{
-    uint8_t values[4];
-    uint8_t mode = 0;
+        return false;
+    }
 
-    Wire.beginTransmission(DS3231_ADDRESS);
-    #if ARDUINO >= 100
-        Wire.write(DS3231_REG_ALARM_1);
-    #else
-        Wire.send(DS3231_REG_ALARM_1);
-    #endif
-    Wire.endTransmission();
+    if ((values[0] & 0b00100000) || (values[1] & 0b00000100))
+    {
+        return false;
+    }
 
-    Wire.requestFrom(DS3231_ADDRESS, 4);
+    conversion = DS3231_CONVERSION_IDLE;
 
-    for (int i = 3; i >= 0; i--)
+    if (conversionCallback)
     {
-        #if ARDUINO >= 100
-            values[i] = bcd2dec(Wire.read());
-        #else
-            values[i] = bcd2dec(Wire.receive());
-        #endif
+        conversionCallback();
     }
 
-    mode |= ((values[3] & 0b01000000) >> 6);
-    mode |= ((values[2] & 0b01000000) >> 5);
-    mode |= ((values[1] & 0b01000000) >> 4);
-    mode |= ((values[0] & 0b01000000) >> 3);
-    mode |= ((values[0] & 0b00100000) >> 1);
+    return true;
+}
 
-    return (DS3231_alarm1_t)mode;
+float DS3231::readTemperature(void)
+{
+    return readTemperatureQuarters() / 4.0f;
 }
 
-void DS3231::setAlarm1(uint8_t dydw, uint8_t hour, uint8_t minute, uint8_t second, DS3231_alarm1_t mode, bool armed)
+// Temperature in 0.25 C steps, without any floating point
+int16_t DS3231::readTemperatureQuarters(void)
 {
-    second = dec2bcd(second);
-    minute = dec2bcd(minute);
-    hour = dec2bcd(hour);
-    dydw = dec2bcd(dydw);
+    uint8_t values[2];
 
-    switch(mode)
+    readRegisters(DS3231_REG_TEMPERATURE, values, 2);
+
+    return decodeTemperature(values[0], values[1]);
+}
+
+// Non-blocking forceConversion() and readTemperatureQuarters(). The first
+// call starts a conversion, later calls return true with its result once
+// it finished. Call it from loop() until it does.
+bool DS3231::pollTemperature(int16_t &quarters)
+{
+    if (!temperatureRequested)
     {
-        case DS3231_EVERY_SECOND:
-            second |= 0b10000000;
-            minute |= 0b10000000;
-            hour |= 0b10000000;
-            dydw |= 0b10000000;
-            break;
+        startConversion();
 
-        case DS3231_MATCH_S:
-            second &= 0b01111111;
-            minute |= 0b10000000;
-            hour |= 0b10000000;
-            dydw |= 0b10000000;
-            break;
+        temperatureRequested = true;
+    }
 
-        case DS3231_MATCH_M_S:
-            second &= 0b01111111;
-            minute &= 0b01111111;
-            hour |= 0b10000000;
-            dydw |= 0b10000000;
-            break;
+    if (!isConversionReady())
+    {
+        return false;
+    }
 
-        case DS3231_MATCH_H_M_S:
-            second &= 0b01111111;
-            minute &= 0b01111111;
-            hour &= 0b01111111;
-            dydw |= 0b10000000;
-            break;
+    temperatureRequested = false;
 
-        case DS3231_MATCH_DT_H_M_S:
-            second &= 0b01111111;
-            minute &= 0b01111111;
-            hour &= 0b01111111;
-            dydw &= 0b01111111;
-            break;
+    quarters = readTemperatureQuarters();
 
-        case DS3231_MATCH_DY_H_M_S:
-            second &= 0b01111111;
-            minute &= 0b01111111;
-            hour &= 0b01111111;
-            dydw &= 0b01111111;
-            dydw |= 0b01000000;
-            break;
-    }
+    return true;
+}
 
-    Wire.beginTransmission(DS3231_ADDRESS);
-    #if ARDUINO >= 100
-        Wire.write(DS3231_REG_ALARM_1);
-        Wire.write(second);
-        Wire.write(minute);
-        Wire.write(hour);
-        Wire.write(dydw);
-    #else
-        Wire.send(DS3231_REG_ALARM_1);
-        Wire.send(second);
-        Wire.send(minute);
-        Wire.send(hour);
-        Wire.send(dydw);
-    #endif
+RTCAlarmTime DS3231::getAlarm1(void)
+{
+    uint8_t values[4];
+
+    readRegisters(DS3231_REG_ALARM_1, values, 4);
 
-    Wire.endTransmission();
+    return decodeAlarm1(values);
+}
+
+DS3231_alarm1_t DS3231::getAlarmType1(void)
+{
+    uint8_t values[4];
 
-    armAlarm1(armed);
+    readRegisters(DS3231_REG_ALARM_1, values, 4);
 
-    clearAlarm1();
+    return decodeAlarmType1(values);
 }
 
-bool DS3231::isAlarm1(bool clear)
+void DS3231::setAlarm1(uint8_t dydw, uint8_t hour, uint8_t minute, uint8_t second, DS3231_alarm1_t mode, bool armed)
 {
-    uint8_t alarm;
+    uint8_t values[4];
 
-    alarm = readRegister8(DS3231_REG_STATUS);
-    alarm &= 0b00000001;
+    encodeAlarm1(values, dydw, hour, minute, second, mode);
 
-    if (alarm && clear)
-    {
-        clearAlarm1();
-    }
+    writeRegisters(DS3231_REG_ALARM_1, values, 4);
+
+    writeAlarmControl(0b00000001, armed);
+}
 
-    return alarm;
+bool DS3231::isAlarm1(bool clear)
+{
+    return pollAlarms(clear ? DS3231_ALARM_1 : 0) & DS3231_ALARM_1;
 }
 
 void DS3231::armAlarm1(bool armed)
 {
     uint8_t value;
-    value = readRegister8(DS3231_REG_CONTROL);
+    value = readControl();
 
     if (armed)
     {
@@ -785,13 +1192,13 @@ void DS3231::armAlarm1(bool armed)
         value &= 0b11111110;
     }
 
-    writeRegister8(DS3231_REG_CONTROL, value);
+    writeControl(value);
 }
 
 bool DS3231::isArmed1(void)
 {
     uint8_t value;
-    value = readRegister8(DS3231_REG_CONTROL);
+    value = readControl();
     value &= 0b00000001;
     return value;
 }
@@ -800,85 +1207,169 @@ void DS3231::clearAlarm1(void)
 {
     uint8_t value;
 
-    value = readRegister8(DS3231_REG_STATUS);
+    value = readStatus();
     value &= 0b11111110;
+    value |= 0b10000010;
 
-    writeRegister8(DS3231_REG_STATUS, value);
+    writeStatus(value);
 }
 
 RTCAlarmTime DS3231::getAlarm2(void)
 {
     uint8_t values[3];
-    RTCAlarmTime a;
 
-    Wire.beginTransmission(DS3231_ADDRESS);
-    #if ARDUINO >= 100
-        Wire.write(DS3231_REG_ALARM_2);
-    #else
-        Wire.send(DS3231_REG_ALARM_2);
-    #endif
-    Wire.endTransmission();
+    readRegisters(DS3231_REG_ALARM_2, values, 3);
 
-    Wire.requestFrom(DS3231_ADDRESS, 3);
+    return decodeAlarm2(values);
+}
 
-    for (int i = 2; i >= 0; i--)
-    {
-        #if ARDUINO >= 100
-            values[i] = bcd2dec(Wire.read() & 0b01111111);
-        #else
-            values[i] = bcd2dec(Wire.receive() & 0b01111111);
-        #endif
-    }
+DS3231_alarm2_t DS3231::getAlarmType2(void)
+{
+    uint8_t values[3];
 
-    a.day = values[0];
-    a.hour = values[1];
-    a.minute = values[2];
-    a.second = 0;
+    readRegisters(DS3231_REG_ALARM_2, values, 3);
 
-    return a;
+    return decodeAlarmType2(values);
 }
 
-DS3231_alarm2_t DS3231::getAlarmType2(void)
+void DS3231::setAlarm2(uint8_t dydw, uint8_t hour, uint8_t minute, DS3231_alarm2_t mode, bool armed)
 {
     uint8_t values[3];
-    uint8_t mode = 0;
 
-    Wire.beginTransmission(DS3231_ADDRESS);
-    #if ARDUINO >= 100
-        Wire.write(DS3231_REG_ALARM_2);
-    #else
-        Wire.send(DS3231_REG_ALARM_2);
-    #endif
-    Wire.endTransmission();
+    encodeAlarm2(values, dydw, hour, minute, mode);
+
+    writeRegisters(DS3231_REG_ALARM_2, values, 3);
+
+    writeAlarmControl(0b00000010, armed);
+}
+
+// Both alarms, CONTROL and STATUS are consecutive, so everything goes out
+// in a single burst.
+void DS3231::setAlarms(const RTCAlarmTime &alarm1, DS3231_alarm1_t mode1, const RTCAlarmTime &alarm2, DS3231_alarm2_t mode2, bool armed)
+{
+    uint8_t values[9];
+
+    encodeAlarm1(values, alarm1.day, alarm1.hour, alarm1.minute, alarm1.second, mode1);
+    encodeAlarm2(values + 4, alarm2.day, alarm2.hour, alarm2.minute, mode2);
+
+    alarmControl(values + 7, 0b00000011, armed);
+
+    writeRegisters(DS3231_REG_ALARM_1, values, 9);
+
+    updateControl(values[7], values[8]);
+}
+
+// Sets or clears the arm bits in CONTROL and clears the matching flags in
+// STATUS, in one burst. The other alarm flag and OSF are written as 1, which
+// leaves them untouched.
+void DS3231::writeAlarmControl(uint8_t alarms, bool armed)
+{
+    uint8_t values[2];
+
+    alarmControl(values, alarms, armed);
+
+    writeRegisters(DS3231_REG_CONTROL, values, 2);
+
+    updateControl(values[0], values[1]);
+}
 
-    Wire.requestFrom(DS3231_ADDRESS, 3);
+void DS3231::alarmControl(uint8_t *values, uint8_t alarms, bool armed)
+{
+    if (!cached)
+    {
+        refresh();
+    }
 
-    for (int i = 2; i >= 0; i--)
+    if (armed)
     {
-        #if ARDUINO >= 100
-            values[i] = bcd2dec(Wire.read());
-        #else
-            values[i] = bcd2dec(Wire.receive());
-        #endif
+        values[0] = control | alarms;
+    } else
+    {
+        values[0] = control & ~alarms;
     }
 
-    mode |= ((values[2] & 0b01000000) >> 5);
-    mode |= ((values[1] & 0b01000000) >> 4);
-    mode |= ((values[0] & 0b01000000) >> 3);
-    mode |= ((values[0] & 0b00100000) >> 1);
+    values[1] = (status | 0b10000011) & ~alarms;
+}
 
-    return (DS3231_alarm2_t)mode;
+void DS3231::encodeDateTime(uint8_t *values, uint16_t year, uint8_t month, uint8_t day, uint8_t hour, uint8_t minute, uint8_t second)
+{
+    values[0] = dec2bcd(second);
+    values[1] = dec2bcd(minute);
+    values[2] = dec2bcd(hour);
+    values[3] = dec2bcd(dow(year, month, day));
+    values[4] = dec2bcd(day);
+    values[5] = dec2bcd(month) | ((year >= 2100) ? 0b10000000 : 0);
+    values[6] = dec2bcd(year % 100);
 }
 
-void DS3231::setAlarm2(uint8_t dydw, uint8_t hour, uint8_t minute, DS3231_alarm2_t mode, bool armed)
+void DS3231::encodeAlarm1(uint8_t *values, uint8_t dydw, uint8_t hour, uint8_t minute, uint8_t second, DS3231_alarm1_t mode)
 {
+    second = dec2bcd(second);
     minute = dec2bcd(minute);
     hour = dec2bcd(hour);
     dydw = dec2bcd(dydw);
 
     switch(mode)
     {
-        case DS3231_EVERY_MINUTE:
+        case DS3231_EVERY_SECOND:
+            second |= 0b10000000;
+            minute |= 0b10000000;
+            hour |= 0b10000000;
+            dydw |= 0b10000000;
+            break;
+
+        case DS3231_MATCH_S:
+            second &= 0b01111111;
+            minute |= 0b10000000;
+            hour |= 0b10000000;
+            dydw |= 0b10000000;
+            break;
+
+        case DS3231_MATCH_M_S:
+            second &= 0b01111111;
+            minute &= 0b01111111;
+            hour |= 0b10000000;
+            dydw |= 0b10000000;
+            break;
+
+        case DS3231_MATCH_H_M_S:
+            second &= 0b01111111;
+            minute &= 0b01111111;
+            hour &= 0b01111111;
+            dydw |= 0b10000000;
+            break;
+
+        case DS3231_MATCH_DT_H_M_S:
+            second &= 0b01111111;
+            minute &= 0b01111111;
+            hour &= 0b01111111;
+            dydw &= 0b01111111;
+            break;
+
+        case DS3231_MATCH_DY_H_M_S:
+            second &= 0b01111111;
+            minute &= 0b01111111;
+            hour &= 0b01111111;
+            dydw &= 0b01111111;
+            dydw |= 0b01000000;
+            break;
+    }
+
+    values[0] = second;
+    values[1] = minute;
+    values[2] = hour;
+    values[3] = dydw;
+}
+
+void DS3231::encodeAlarm2(uint8_t *values, uint8_t dydw, uint8_t hour, uint8_t minute, DS3231_alarm2_t mode)
+{
+    minute = dec2bcd(minute);
+    hour = dec2bcd(hour);
+    dydw = dec2bcd(dydw);
+
+    switch(mode)
+    {
+        case DS3231_EVERY_MINUTE:
             minute |= 0b10000000;
             hour |= 0b10000000;
             dydw |= 0b10000000;
@@ -910,30 +1401,15 @@ void DS3231::setAlarm2(uint8_t dydw, uint8_t hour, uint8_t minute, DS3231_alarm2
             break;
     }
 
-    Wire.beginTransmission(DS3231_ADDRESS);
-    #if ARDUINO >= 100
-        Wire.write(DS3231_REG_ALARM_2);
-        Wire.write(minute);
-        Wire.write(hour);
-        Wire.write(dydw);
-    #else
-        Wire.send(DS3231_REG_ALARM_2);
-        Wire.send(minute);
-        Wire.send(hour);
-        Wire.send(dydw);
-    #endif
-
-    Wire.endTransmission();
-
-    armAlarm2(armed);
-
-    clearAlarm2();
+    values[0] = minute;
+    values[1] = hour;
+    values[2] = dydw;
 }
 
 void DS3231::armAlarm2(bool armed)
 {
     uint8_t value;
-    value = readRegister8(DS3231_REG_CONTROL);
+    value = readControl();
 
     if (armed)
     {
@@ -943,13 +1419,13 @@ void DS3231::armAlarm2(bool armed)
         value &= 0b11111101;
     }
 
-    writeRegister8(DS3231_REG_CONTROL, value);
+    writeControl(value);
 }
 
 bool DS3231::isArmed2(void)
 {
     uint8_t value;
-    value = readRegister8(DS3231_REG_CONTROL);
+    value = readControl();
     value &= 0b00000010;
     value >>= 1;
     return value;
@@ -960,294 +1436,794 @@ void DS3231::clearAlarm2(void)
 {
     uint8_t value;
 
-    value = readRegister8(DS3231_REG_STATUS);
+    value = readStatus();
     value &= 0b11111101;
+    value |= 0b10000001;
 
-    writeRegister8(DS3231_REG_STATUS, value);
+    writeStatus(value);
 }
 
 
 bool DS3231::isAlarm2(bool clear)
 {
-    uint8_t alarm;
+    return pollAlarms(clear ? DS3231_ALARM_2 : 0) & DS3231_ALARM_2;
+}
 
-    alarm = readRegister8(DS3231_REG_STATUS);
-    alarm &= 0b00000010;
+// Returns the unixtime at which alarm 1 next fires strictly after now, or 0
+// if the alarm can never match. Repeating modes are a modulo of the time
+// within their period, a date match walks the months until one is long
+// enough.
+uint32_t DS3231::nextAlarm1(const RTCDateTime &now, const RTCAlarmTime &alarm, DS3231_alarm1_t mode)
+{
+    uint32_t period;
+    uint32_t target;
+    uint32_t current;
 
-    if (alarm && clear)
+    if ((alarm.second > 59) || (alarm.minute > 59) || (alarm.hour > 23))
     {
-        clearAlarm2();
+        return 0;
     }
 
-    return alarm;
-}
-
-uint8_t DS3231::bcd2dec(uint8_t bcd)
-{
-    return ((bcd / 16) * 10) + (bcd % 16);
-}
-
-uint8_t DS3231::dec2bcd(uint8_t dec)
-{
-    return ((dec / 10) * 16) + (dec % 10);
-}
+    switch (mode)
+    {
+        case DS3231_EVERY_SECOND:
+            return now.unixtime + 1;
 
-char *DS3231::strDayOfWeek(uint8_t dayOfWeek)
-{
-    switch (dayOfWeek) {
-        case 1:
-            return (char*) "Monday";
-            break;
-        case 2:
-            return (char*) "Tuesday";
-            break;
-        case 3:
-            return (char*) "Wednesday";
-            break;
-        case 4:
-            return (char*) "Thursday";
+        case DS3231_MATCH_S:
+            period = 60;
+            target = alarm.second;
+            current = now.second;
             break;
-        case 5:
-            return (char*) "Friday";
+
+        case DS3231_MATCH_M_S:
+            period = 3600;
+            target = alarm.minute * 60 + alarm.second;
+            current = now.minute * 60 + now.second;
             break;
-        case 6:
-            return (char*) "Saturday";
+
+        case DS3231_MATCH_H_M_S:
+            period = 86400;
+            target = time2long(0, alarm.hour, alarm.minute, alarm.second);
+            current = time2long(0, now.hour, now.minute, now.second);
             break;
-        case 7:
-            return (char*) "Sunday";
+
+        case DS3231_MATCH_DY_H_M_S:
+            if ((alarm.day < 1) || (alarm.day > 7))
+            {
+                return 0;
+            }
+
+            period = 604800;
+            target = time2long(alarm.day - 1, alarm.hour, alarm.minute, alarm.second);
+            current = time2long(now.dayOfWeek - 1, now.hour, now.minute, now.second);
             break;
+
         default:
-            return (char*) "Unknown";
+            return nextAlarmDate(now, alarm);
     }
+
+    return now.unixtime + period - (current + period - target) % period;
 }
 
-char *DS3231::strMonth(uint8_t month)
+// Alarm 2 fires like alarm 1 with the seconds matched at 0
+uint32_t DS3231::nextAlarm2(const RTCDateTime &now, const RTCAlarmTime &alarm, DS3231_alarm2_t mode)
 {
-    switch (month) {
-        case 1:
-            return (char*) "January";
-            break;
-        case 2:
-            return (char*) "February";
-            break;
-        case 3:
-            return (char*) "March";
-            break;
-        case 4:
-            return (char*) "April";
-            break;
-        case 5:
-            return (char*) "May";
-            break;
-        case 6:
-            return (char*) "June";
-            break;
-        case 7:
-            return (char*) "July";
-            break;
-        case 8:
-            return (char*) "August";
-            break;
-        case 9:
-            return (char*) "September";
+    RTCAlarmTime a = alarm;
+    DS3231_alarm1_t mode1;
+
+    a.second = 0;
+
+    switch (mode)
+    {
+        case DS3231_EVERY_MINUTE:
+            mode1 = DS3231_MATCH_S;
             break;
-        case 10:
-            return (char*) "October";
+        case DS3231_MATCH_M:
+            mode1 = DS3231_MATCH_M_S;
             break;
-        case 11:
-            return (char*) "November";
+        case DS3231_MATCH_H_M:
+            mode1 = DS3231_MATCH_H_M_S;
             break;
-        case 12:
-            return (char*) "December";
+        case DS3231_MATCH_DY_H_M:
+            mode1 = DS3231_MATCH_DY_H_M_S;
             break;
         default:
-            return (char*) "Unknown";
+            mode1 = DS3231_MATCH_DT_H_M_S;
+            break;
     }
+
+    return nextAlarm1(now, a, mode1);
 }
 
-char *DS3231::strAmPm(uint8_t hour, bool uppercase)
+uint32_t DS3231::nextAlarmDate(const RTCDateTime &now, const RTCAlarmTime &alarm)
 {
-    if (hour < 12)
+    RTCDateTime t;
+
+    if ((alarm.day < 1) || (alarm.day > 31))
     {
-        if (uppercase)
-        {
-            return (char*) "AM";
-        } else
-        {
-            return (char*) "am";
-        }
-    } else
+        return 0;
+    }
+
+    t.year = now.year;
+    t.month = now.month;
+    t.day = alarm.day;
+    t.hour = alarm.hour;
+    t.minute = alarm.minute;
+    t.second = alarm.second;
+
+    // Later this month, or the first following month that has the date
+    if ((alarm.day < now.day) ||
+        ((alarm.day == now.day) && (time2long(0, alarm.hour, alarm.minute, alarm.second) <= time2long(0, now.hour, now.minute, now.second))) ||
+        (alarm.day > daysInMonth(t.year, t.month)))
     {
-        if (uppercase)
-        {
-            return (char*) "PM";
-        } else
+        do
         {
-            return (char*) "pm";
-        }
+            if (++t.month > 12)
+            {
+                t.month = 1;
+                ++t.year;
+            }
+        } while (alarm.day > daysInMonth(t.year, t.month));
     }
+
+    return unixtime(t);
 }
 
-char *DS3231::strDaySufix(uint8_t day)
+// Reads STATUS once and returns the raised DS3231_ALARM_1, DS3231_ALARM_2,
+// DS3231_BUSY and DS3231_STOPPED flags. Raised flags selected by acknowledge
+// are cleared with a single write. Every other flag is written as 1, which
+// the chip ignores, so a flag raised after the read is kept.
+uint8_t DS3231::pollAlarms(uint8_t acknowledge)
 {
-     if (day >= 11 && day <= 13)
-     {
-         return (char*) "th";
-     }
+    uint8_t flags;
+
+    status = readRegister8(DS3231_REG_STATUS);
+
+    flags = status & (DS3231_ALARM_1 | DS3231_ALARM_2 | DS3231_BUSY | DS3231_STOPPED);
 
-     switch (day % 10)
-     {
-         case 1:
-             return (char*) "st";
-             break;
-         case 2:
-             return (char*) "nd";
-             break;
-         case 3:
-             return (char*) "rd";
-             break;
-         default:
-             return (char*) "th";
-         break;
-      }
+    acknowledge &= flags & (DS3231_ALARM_1 | DS3231_ALARM_2 | DS3231_STOPPED);
+
+    if (acknowledge)
+    {
+        writeStatus((status | DS3231_ALARM_1 | DS3231_ALARM_2 | DS3231_STOPPED) & ~acknowledge);
+    }
+
+    return flags;
+}
+
+RTCDateTime DS3231::decodeDateTime(const uint8_t *values)
+{
+    RTCDateTime dt;
+
+    dt.second = bcd2dec(values[0]);
+    dt.minute = bcd2dec(values[1]);
+    dt.hour = bcd2dec(values[2]);
+    dt.dayOfWeek = bcd2dec(values[3]);
+    dt.day = bcd2dec(values[4]);
+    dt.month = bcd2dec(values[5] & 0b00011111);
+    dt.year = bcd2dec(values[6]) + ((values[5] & 0b10000000) ? 2100 : 2000);
+    dt.unixtime = unixtime(dt);
+
+    return dt;
+}
+
+RTCAlarmTime DS3231::decodeAlarm1(const uint8_t *values)
+{
+    RTCAlarmTime a;
+
+    a.second = bcd2dec(values[0] & 0b01111111);
+    a.minute = bcd2dec(values[1] & 0b01111111);
+    a.hour = bcd2dec(values[2] & 0b00111111);
+    a.day = bcd2dec(values[3] & 0b00111111);
+
+    return a;
+}
+
+DS3231_alarm1_t DS3231::decodeAlarmType1(const uint8_t *values)
+{
+    uint8_t mode = 0;
+
+    mode |= ((values[0] & 0b10000000) >> 7);
+    mode |= ((values[1] & 0b10000000) >> 6);
+    mode |= ((values[2] & 0b10000000) >> 5);
+    mode |= ((values[3] & 0b10000000) >> 4);
+    mode |= ((values[3] & 0b01000000) >> 2);
+
+    return (DS3231_alarm1_t)mode;
 }
 
-uint8_t DS3231::hour12(uint8_t hour24)
+RTCAlarmTime DS3231::decodeAlarm2(const uint8_t *values)
 {
-    if (hour24 == 0)
+    RTCAlarmTime a;
+
+    a.second = 0;
+    a.minute = bcd2dec(values[0] & 0b01111111);
+    a.hour = bcd2dec(values[1] & 0b00111111);
+    a.day = bcd2dec(values[2] & 0b00111111);
+
+    return a;
+}
+
+DS3231_alarm2_t DS3231::decodeAlarmType2(const uint8_t *values)
+{
+    uint8_t mode = 0;
+
+    mode |= ((values[0] & 0b10000000) >> 6);
+    mode |= ((values[1] & 0b10000000) >> 5);
+    mode |= ((values[2] & 0b10000000) >> 4);
+    mode |= ((values[2] & 0b01000000) >> 2);
+
+    return (DS3231_alarm2_t)mode;
+}
+
+int16_t DS3231::decodeTemperature(uint8_t msb, uint8_t lsb)
+{
+    return (int16_t)(((uint16_t)msb << 8) | lsb) >> 6;
+}
+
+uint8_t DS3231::bcd2dec(uint8_t bcd)
+{
+    return ((bcd / 16) * 10) + (bcd % 16);
+}
+
+uint8_t DS3231::dec2bcd(uint8_t dec)
+{
+    return ((dec / 10) * 16) + (dec % 10);
+}
+
+uint32_t DS3231::time2long(uint32_t days, uint8_t hours, uint8_t minutes, uint8_t seconds)
+{
+    return ((days * 24UL + hours) * 60 + minutes) * 60 + seconds;
+}
+
+bool DS3231::isLeapYear(uint16_t year)
+{
+    return DS3231Calendar::isLeapYear(year);
+}
+
+uint8_t DS3231::daysInMonth(uint16_t year, uint8_t month)
+{
+    return DS3231Calendar::daysInMonth(year, month);
+}
+
+uint32_t DS3231::date2days(uint16_t year, uint8_t month, uint8_t day)
+{
+    return DS3231Calendar::days(year, month, day);
+}
+
+void DS3231::days2date(uint32_t days, RTCDateTime &dt)
+{
+    uint32_t z = days + 306;
+    uint16_t cycle;
+    uint16_t rest;
+    uint8_t y;
+    uint16_t doy;
+    uint8_t m;
+
+    // Insert the February 29th that 2100 does not have
+    if (z >= 36890)
     {
-        return 12;
+        ++z;
     }
 
-    if (hour24 > 12)
+    cycle = z / 1461;
+    rest = z - (uint32_t)cycle * 1461;
+
+    // The first year of every cycle is the leap one
+    if (rest < 366)
+    {
+        y = 0;
+        doy = rest;
+    } else
     {
-       return (hour24 - 12);
+        y = (rest - 1) / 365;
+        doy = rest - 1 - 365 * y;
     }
 
-    return hour24;
+    m = (5 * doy + 2) / 153;
+
+    dt.day = doy - (153 * m + 2) / 5 + 1;
+    dt.month = (m < 10) ? (m + 3) : (m - 9);
+    dt.year = 1999 + cycle * 4 + y + (dt.month <= 2);
+    dt.dayOfWeek = (days + 5) % 7 + 1;
 }
 
-long DS3231::time2long(uint16_t days, uint8_t hours, uint8_t minutes, uint8_t seconds)
+uint32_t DS3231::unixtime(const RTCDateTime &t)
 {
-    return ((days * 24L + hours) * 60 + minutes) * 60 + seconds;
+    uint32_t u;
+
+    u = time2long(date2days(t.year, t.month, t.day), t.hour, t.minute, t.second);
+    u += DS3231_EPOCH;
+
+    return u;
 }
 
-uint16_t DS3231::dayInYear(uint16_t year, uint8_t month, uint8_t day)
+uint8_t DS3231::dow(uint16_t y, uint8_t m, uint8_t d)
 {
-    uint16_t fromDate;
-    uint16_t toDate;
+    return (date2days(y, m, d) + 5) % 7 + 1;
+}
 
-    fromDate = date2days(year, 1, 1);
-    toDate = date2days(year, month, day);
+void DS3231::enablePreciseClock(void)
+{
+    setOutput(DS3231_1HZ);
+    enableOutput(true);
 
-    return (toDate - fromDate);
+    noInterrupts();
+    sqwEdges = 0;
+    sqwPeriod = 16000000;
+    interrupts();
+
+    sqwSynced = false;
 }
 
-bool DS3231::isLeapYear(uint16_t year)
+// Call from the FALLING edge interrupt of SQW, the seconds register
+// is updated on that edge.
+void DS3231::handleSqw(void)
 {
-    return (year % 4 == 0);
+    uint32_t edge = micros();
+    uint32_t period = edge - sqwMicros;
+
+    // Skip edges around a missed one, 2% covers ceramic resonators
+    if (sqwEdges && (period > 980000) && (period < 1020000))
+    {
+        // Running average over 8 seconds, kept in 1/16 us
+        sqwPeriod += ((int32_t)(period * 16) - (int32_t)sqwPeriod) / 8;
+    }
+
+    sqwMicros = edge;
+    sqwEdges++;
 }
 
-uint8_t DS3231::daysInMonth(uint16_t year, uint8_t month)
+RTCPreciseTime DS3231::now(void)
 {
-    uint8_t days;
+    RTCPreciseTime p;
+    uint32_t edges;
+    uint32_t edgeMicros;
+    uint32_t period;
+    uint32_t elapsed;
+    int32_t delta;
+
+    noInterrupts();
+    edges = sqwEdges;
+    interrupts();
+
+    if (!edges)
+    {
+        p.unixtime = readDateTime().unixtime;
+        p.micros = 0;
 
-    days = pgm_read_byte(daysArray + month - 1);
+        return p;
+    }
 
-    if ((month == 2) && isLeapYear(year))
+    // Pair the time registers with the edge count they belong to
+    while (!sqwSynced)
     {
-        ++days;
+        sqwUnixtime = readDateTime().unixtime;
+
+        noInterrupts();
+        sqwSynced = (edges == sqwEdges);
+        edges = sqwEdges;
+        interrupts();
+
+        sqwBase = edges;
     }
 
-    return days;
+    noInterrupts();
+    edges = sqwEdges;
+    edgeMicros = sqwMicros;
+    period = sqwPeriod / 16;
+    interrupts();
+
+    p.unixtime = sqwUnixtime + (edges - sqwBase);
+
+    elapsed = micros() - edgeMicros;
+
+    // An edge may be pending while interrupts are off
+    while (elapsed >= period)
+    {
+        elapsed -= period;
+        p.unixtime++;
+    }
+
+    // Scale MCU microseconds to RTC microseconds without 64-bit math
+    delta = (int32_t)period - 1000000;
+    p.micros = elapsed - ((int32_t)(elapsed >> 4) * delta) / 62500;
+
+    if (p.micros > 999999)
+    {
+        p.micros = 999999;
+    }
+
+    return p;
 }
 
-uint16_t DS3231::date2days(uint16_t year, uint8_t month, uint8_t day)
+uint32_t DS3231::getSqwPeriod(void)
 {
-    year = year - 2000;
+    return sqwPeriod / 16;
+}
 
-    uint16_t days16 = day;
+// Sets the clock so its seconds boundaries fall on those of reference,
+// taken at micros() value at. The write is timed so the seconds byte is
+// latched on the next boundary at least one write ahead, which blocks for
+// up to a second. The seconds write restarts the countdown chain, so with
+// enablePreciseClock() the first SQW edge after it must come one second
+// after the boundary; getSetError() is how far off it came. Returns false
+// if the write fails or that edge is missing or off by more than
+// DS3231_SET_TOLERANCE us.
+bool DS3231::setPreciseTime(const RTCPreciseTime &reference, uint32_t at)
+{
+    uint8_t values[7];
+    uint32_t start;
+    uint32_t lead;
+    uint32_t boundary;
+    uint32_t unixtime;
+    uint32_t edges;
+    uint32_t edgeMicros;
+    RTCDateTime dt;
+
+    // Time a write of the same length that changes nothing: the alarm
+    // registers written back with their own values
+    if (!readRegisters(DS3231_REG_ALARM_1, values, 7))
+    {
+        return false;
+    }
+
+    start = micros();
+    writeRegisters(DS3231_REG_ALARM_1, values, 7);
+    setLatency = micros() - start;
+
+    // The seconds are latched on their ACK, three of the nine bytes in
+    lead = setLatency / 3;
+
+    unixtime = reference.unixtime + 1;
+    boundary = at + (1000000 - reference.micros);
+
+    while ((int32_t)(boundary - lead - micros()) < (int32_t)setLatency)
+    {
+        boundary += 1000000;
+        unixtime++;
+    }
+
+    dt = loadDateTimeFromLong(unixtime);
+    encodeDateTime(values, dt.year, dt.month, dt.day, dt.hour, dt.minute, dt.second);
+
+    while ((int32_t)(micros() - (boundary - lead)) < 0)
+    {
+    }
+
+    if (!writeRegisters(DS3231_REG_TIME, values, 7))
+    {
+        return false;
+    }
+
+    sqwSynced = false;
+    softSynced = false;
+    setError = 0;
+
+    noInterrupts();
+    edges = sqwEdges;
+    interrupts();
+
+    if (!edges)
+    {
+        return true;
+    }
 
-    for (uint8_t i = 1; i < month; ++i)
+    // Edges in the first half second are the output restarting
+    do
     {
-        days16 += pgm_read_byte(daysArray + i - 1);
-        if ((month == 1) && isLeapYear(year))
+        if ((int32_t)(micros() - boundary) > 1500000)
         {
-            ++days16;
+            return false;
         }
-    }
 
-    return days16 + 365 * year + (year + 3) / 4 - 1;
+        noInterrupts();
+        edgeMicros = sqwMicros;
+        interrupts();
+    } while ((int32_t)(edgeMicros - boundary) < 500000);
+
+    setError = (int32_t)(edgeMicros - boundary - 1000000);
+
+    return (setError >= -DS3231_SET_TOLERANCE) && (setError <= DS3231_SET_TOLERANCE);
 }
 
-uint32_t DS3231::unixtime(void)
+// Microseconds the first SQW edge came after the one expected, as of the
+// last setPreciseTime()
+int32_t DS3231::getSetError(void)
 {
-    uint32_t u;
+    return setError;
+}
 
-    u = time2long(date2days(t.year, t.month, t.day), t.hour, t.minute, t.second);
-    u += 946681200;
+// Duration of a 7 byte register write, as measured by setPreciseTime()
+uint32_t DS3231::getSetLatency(void)
+{
+    return setLatency;
+}
 
-    return u;
+// Serve getDateTime() from millis() and read the chip at most every
+// interval ms. The interval shrinks while the MCU clock drifts more than
+// a second between reads. Zero disables the software clock.
+void DS3231::enableSoftClock(uint32_t interval)
+{
+    softInterval = interval;
+    softLimit = interval;
+    softSynced = false;
+}
+
+uint32_t DS3231::getSoftClockHits(void)
+{
+    return softHits;
+}
+
+uint32_t DS3231::getSoftClockMisses(void)
+{
+    return softMisses;
+}
+
+void DS3231::resetSoftClockCounters(void)
+{
+    softHits = 0;
+    softMisses = 0;
+}
+
+void DS3231::enableCache(bool enabled)
+{
+    // A cache that could not be filled would write garbage back
+    cached = enabled && refresh();
+}
+
+bool DS3231::isCached(void)
+{
+    return cached;
 }
 
-uint8_t DS3231::conv2d(const char* p)
+// Reloads the cached CONTROL and STATUS. Returns false and keeps the old
+// copies when the bus fails.
+bool DS3231::refresh(void)
 {
-    uint8_t v = 0;
+    uint8_t values[2];
 
-    if ('0' <= *p && *p <= '9')
+    if (!readRegisters(DS3231_REG_CONTROL, values, 2))
     {
-        v = *p - '0';
+        return false;
     }
 
-    return 10 * v + *++p - '0';
+    control = values[0] & 0b11011111;
+    status = values[1];
+
+    return true;
 }
 
-uint8_t DS3231::dow(uint16_t y, uint8_t m, uint8_t d)
+uint8_t DS3231::readControl(void)
+{
+    if (!cached)
+    {
+        control = readRegister8(DS3231_REG_CONTROL) & 0b11011111;
+    }
+
+    return control;
+}
+
+void DS3231::writeControl(uint8_t value)
 {
-    uint8_t dow;
+    writeRegister8(DS3231_REG_CONTROL, value);
 
-    y -= m < 3;
-    dow = ((y + y/4 - y/100 + y/400 + pgm_read_byte(dowArray+(m-1)) + d) % 7);
+    // CONV clears itself when the conversion is done, so it is never cached
+    control = value & 0b11011111;
+}
 
-    if (dow == 0)
+uint8_t DS3231::readStatus(void)
+{
+    if (!cached)
     {
-        return 7;
+        status = readRegister8(DS3231_REG_STATUS);
     }
 
-    return dow;
+    return status;
+}
+
+// OSF, A2F and A1F are cleared by writing 0 and kept by writing 1, so
+// callers write 1 for every flag they do not mean to acknowledge. The
+// cached STATUS may be stale and a flag raised since must survive.
+void DS3231::writeStatus(uint8_t value)
+{
+    writeRegister8(DS3231_REG_STATUS, value);
+
+    updateStatus(value);
+}
+
+void DS3231::updateControl(uint8_t control, uint8_t status)
+{
+    this->control = control & 0b11011111;
+
+    updateStatus(status);
+}
+
+void DS3231::updateStatus(uint8_t value)
+{
+    // OSF, A2F and A1F can only be cleared by a write, BSY is read only
+    status = (value & 0b00001000) | (status & 0b00000100) | (status & value & 0b10000011);
 }
 
 void DS3231::writeRegister8(uint8_t reg, uint8_t value)
 {
-    Wire.beginTransmission(DS3231_ADDRESS);
-    #if ARDUINO >= 100
-        Wire.write(reg);
-        Wire.write(value);
-    #else
-        Wire.send(reg);
-        Wire.send(value);
-    #endif
-    Wire.endTransmission();
+    writeRegisters(reg, &value, 1);
 }
 
 uint8_t DS3231::readRegister8(uint8_t reg)
 {
-    uint8_t value;
-    Wire.beginTransmission(DS3231_ADDRESS);
+    uint8_t value = 0;
+
+    readRegisters(reg, &value, 1);
+
+    return value;
+}
+
+bool DS3231::writeRegisters(uint8_t reg, const uint8_t *values, uint8_t count)
+{
+    return bus->writeRegisters(address, reg, values, count);
+}
+
+bool DS3231::readRegisters(uint8_t reg, uint8_t *values, uint8_t count)
+{
+    return bus->readRegisters(address, reg, values, count);
+}
+
+DS3231TwoWire::DS3231TwoWire(TwoWire &wire)
+{
+    this->wire = &wire;
+}
+
+bool DS3231TwoWire::writeRegisters(uint8_t address, uint8_t reg, const uint8_t *values, uint8_t count)
+{
+    wire->beginTransmission(address);
+
     #if ARDUINO >= 100
-        Wire.write(reg);
+        wire->write(reg);
+        wire->write(values, count);
     #else
-        Wire.send(reg);
+        wire->send(reg);
+        wire->send((uint8_t*)values, count);
     #endif
-    Wire.endTransmission();
 
-    Wire.requestFrom(DS3231_ADDRESS, 1);
+    return (wire->endTransmission() == 0);
+}
+
+bool DS3231TwoWire::readRegisters(uint8_t address, uint8_t reg, uint8_t *values, uint8_t count)
+{
+    wire->beginTransmission(address);
 
     #if ARDUINO >= 100
-        value = Wire.read();
+        wire->write(reg);
     #else
-        value = Wire.receive();
+        wire->send(reg);
     #endif
 
-    return value;
+    if (wire->endTransmission() != 0)
+    {
+        return false;
+    }
+
+    if (wire->requestFrom(address, count) != count)
+    {
+        return false;
+    }
+
+    for (uint8_t i = 0; i < count; i++)
+    {
+        #if ARDUINO >= 100
+            values[i] = wire->read();
+        #else
+            values[i] = wire->receive();
+        #endif
+    }
+
+    return true;
+}
+
+DS3231Snapshot::DS3231Snapshot(void)
+{
+    memset(values, 0, sizeof(values));
+    decoded = false;
+}
+
+RTCDateTime DS3231Snapshot::getDateTime(void)
+{
+    if (!decoded)
+    {
+        t = DS3231::decodeDateTime(values + DS3231_REG_TIME);
+        decoded = true;
+    }
+
+    return t;
+}
+
+RTCAlarmTime DS3231Snapshot::getAlarm1(void)
+{
+    return DS3231::decodeAlarm1(values + DS3231_REG_ALARM_1);
+}
+
+DS3231_alarm1_t DS3231Snapshot::getAlarmType1(void)
+{
+    return DS3231::decodeAlarmType1(values + DS3231_REG_ALARM_1);
+}
+
+RTCAlarmTime DS3231Snapshot::getAlarm2(void)
+{
+    return DS3231::decodeAlarm2(values + DS3231_REG_ALARM_2);
+}
+
+DS3231_alarm2_t DS3231Snapshot::getAlarmType2(void)
+{
+    return DS3231::decodeAlarmType2(values + DS3231_REG_ALARM_2);
+}
+
+uint8_t DS3231Snapshot::getControl(void)
+{
+    return values[DS3231_REG_CONTROL];
+}
+
+uint8_t DS3231Snapshot::getStatus(void)
+{
+    return values[DS3231_REG_STATUS];
+}
+
+int8_t DS3231Snapshot::getAging(void)
+{
+    return (int8_t)values[DS3231_REG_AGING];
+}
+
+DS3231_sqw_t DS3231Snapshot::getOutput(void)
+{
+    return (DS3231_sqw_t)((values[DS3231_REG_CONTROL] & 0b00011000) >> 3);
+}
+
+bool DS3231Snapshot::isOutput(void)
+{
+    return !(values[DS3231_REG_CONTROL] & 0b00000100);
+}
+
+bool DS3231Snapshot::is32kHz(void)
+{
+    return values[DS3231_REG_STATUS] & 0b00001000;
+}
+
+bool DS3231Snapshot::isArmed1(void)
+{
+    return values[DS3231_REG_CONTROL] & 0b00000001;
+}
+
+bool DS3231Snapshot::isArmed2(void)
+{
+    return values[DS3231_REG_CONTROL] & 0b00000010;
+}
+
+bool DS3231Snapshot::isAlarm1(void)
+{
+    return values[DS3231_REG_STATUS] & 0b00000001;
+}
+
+bool DS3231Snapshot::isAlarm2(void)
+{
+    return values[DS3231_REG_STATUS] & 0b00000010;
+}
+
+bool DS3231Snapshot::isBusy(void)
+{
+    return values[DS3231_REG_STATUS] & 0b00000100;
+}
+
+bool DS3231Snapshot::isOscillatorStopped(void)
+{
+    return values[DS3231_REG_STATUS] & 0b10000000;
+}
+
+float DS3231Snapshot::getTemperature(void)
+{
+    return getTemperatureQuarters() / 4.0f;
+}
+
+int16_t DS3231Snapshot::getTemperatureQuarters(void)
+{
+    return DS3231::decodeTemperature(values[DS3231_REG_TEMPERATURE], values[DS3231_REG_TEMPERATURE + 1]);
 }
@@ -34,6 +34,8 @@ SOFTWARE.
 #include "WProgram.h"
 #endif
 
+#include <Wire.h>
+
 #define DS3231_ADDRESS              (0x68)
 
 #define DS3231_REG_TIME             (0x00)
@@ -41,8 +43,22 @@ SOFTWARE.
 #define DS3231_REG_ALARM_2          (0x0B)
 #define DS3231_REG_CONTROL          (0x0E)
 #define DS3231_REG_STATUS           (0x0F)
+#define DS3231_REG_AGING            (0x10)
 #define DS3231_REG_TEMPERATURE      (0x11)
 
+#define DS3231_SNAPSHOT_SIZE        (0x13)
+
+#define DS3231_EPOCH                (946684800)
+
+#define DS3231_CONVERSION_POLL      (10)
+#define DS3231_CONVERSION_TIMEOUT   (500)
+#define DS3231_SET_TOLERANCE        (1000)
+
+#define DS3231_ALARM_1              (0b00000001)
+#define DS3231_ALARM_2              (0b00000010)
+#define DS3231_BUSY                 (0b00000100)
+#define DS3231_STOPPED              (0b10000000)
+
 #ifndef RTCDATETIME_STRUCT_H
 #define RTCDATETIME_STRUCT_H
 struct RTCDateTime
@@ -66,6 +82,12 @@ struct RTCAlarmTime
 };
 #endif
 
+struct RTCPreciseTime
+{
+    uint32_t unixtime;
+    uint32_t micros;
+};
+
 typedef enum
 {
     DS3231_1HZ          = 0x00,
@@ -93,18 +115,100 @@ typedef enum
     DS3231_MATCH_DY_H_M   = 0b00010000
 } DS3231_alarm2_t;
 
+typedef enum
+{
+    DS3231_CONVERSION_IDLE    = 0x00,
+    DS3231_CONVERSION_WAITING = 0x01,
+    DS3231_CONVERSION_RUNNING = 0x02
+} DS3231_conversion_t;
+
+class DS3231Bus
+{
+    public:
+
+	virtual bool readRegisters(uint8_t address, uint8_t reg, uint8_t *values, uint8_t count) = 0;
+	virtual bool writeRegisters(uint8_t address, uint8_t reg, const uint8_t *values, uint8_t count) = 0;
+};
+
+class DS3231TwoWire : public DS3231Bus
+{
+    public:
+
+	DS3231TwoWire(TwoWire &wire);
+
+	virtual bool readRegisters(uint8_t address, uint8_t reg, uint8_t *values, uint8_t count);
+	virtual bool writeRegisters(uint8_t address, uint8_t reg, const uint8_t *values, uint8_t count);
+
+    private:
+	TwoWire *wire;
+};
+
+class DS3231Snapshot
+{
+    public:
+
+	DS3231Snapshot(void);
+
+	RTCDateTime getDateTime(void);
+
+	RTCAlarmTime getAlarm1(void);
+	DS3231_alarm1_t getAlarmType1(void);
+	RTCAlarmTime getAlarm2(void);
+	DS3231_alarm2_t getAlarmType2(void);
+
+	uint8_t getControl(void);
+	uint8_t getStatus(void);
+	int8_t getAging(void);
+
+	DS3231_sqw_t getOutput(void);
+	bool isOutput(void);
+	bool is32kHz(void);
+
+	bool isArmed1(void);
+	bool isArmed2(void);
+	bool isAlarm1(void);
+	bool isAlarm2(void);
+	bool isBusy(void);
+	bool isOscillatorStopped(void);
+
+	float getTemperature(void);
+	int16_t getTemperatureQuarters(void);
+
+    private:
+	friend class DS3231;
+
+	uint8_t values[DS3231_SNAPSHOT_SIZE];
+	bool decoded;
+	RTCDateTime t;
+};
+
 class DS3231
 {
     public:
 
+	DS3231(uint8_t address = DS3231_ADDRESS);
+
 	bool begin(void);
+	bool begin(TwoWire &wire);
+	bool begin(DS3231Bus &bus);
+
+	uint8_t getAddress(void);
 
 	void setDateTime(uint16_t year, uint8_t month, uint8_t day, uint8_t hour, uint8_t minute, uint8_t second);
 	void setDateTime(uint32_t t);
-	void setDateTime(const char* date, const char* time);
+	void setDateTime(const RTCDateTime &dt);
+	bool setDateTime(const char* date, const char* time);
+
+	static bool parseDateTime(const char *date, const char *time, RTCDateTime &dt);
+	static bool parseIso8601(const char *str, RTCDateTime &dt);
+	static bool parseRfc3339(const char *str, RTCDateTime &dt);
 	RTCDateTime getDateTime(void);
+	RTCDateTime readDateTime(void);
+	bool readDateTime(RTCDateTime &dt);
 	uint8_t isReady(void);
 
+	bool readSnapshot(DS3231Snapshot &snapshot);
+
 	DS3231_sqw_t getOutput(void);
 	void setOutput(DS3231_sqw_t mode);
 	void enableOutput(bool enabled);
@@ -112,8 +216,13 @@ class DS3231
 	void enable32kHz(bool enabled);
 	bool is32kHz(void);
 
-	void forceConversion(void);
+	bool forceConversion(void);
+	void startConversion(void);
+	bool isConversionReady(void);
+	void setConversionCallback(void (*callback)(void));
 	float readTemperature(void);
+	int16_t readTemperatureQuarters(void);
+	bool pollTemperature(int16_t &quarters);
 
 	void setAlarm1(uint8_t dydw, uint8_t hour, uint8_t minute, uint8_t second, DS3231_alarm1_t mode, bool armed = true);
 	RTCAlarmTime getAlarm1(void);
@@ -131,37 +240,134 @@ class DS3231
 	bool isArmed2(void);
 	void clearAlarm2(void);
 
+	uint8_t pollAlarms(uint8_t acknowledge = DS3231_ALARM_1 | DS3231_ALARM_2);
+	void setAlarms(const RTCAlarmTime &alarm1, DS3231_alarm1_t mode1, const RTCAlarmTime &alarm2, DS3231_alarm2_t mode2, bool armed = true);
+
+	static uint32_t nextAlarm1(const RTCDateTime &now, const RTCAlarmTime &alarm, DS3231_alarm1_t mode);
+	static uint32_t nextAlarm2(const RTCDateTime &now, const RTCAlarmTime &alarm, DS3231_alarm2_t mode);
+
 	void setBattery(bool timeBattery, bool squareBattery);
 
+	void setAging(int8_t offset);
+	int8_t getAging(void);
+
+	void enablePreciseClock(void);
+	void handleSqw(void);
+	RTCPreciseTime now(void);
+	uint32_t getSqwPeriod(void);
+
+	bool setPreciseTime(const RTCPreciseTime &reference, uint32_t at);
+	int32_t getSetError(void);
+	uint32_t getSetLatency(void);
+
+	void enableSoftClock(uint32_t interval);
+	uint32_t getSoftClockHits(void);
+	uint32_t getSoftClockMisses(void);
+	void resetSoftClockCounters(void);
+
+	void enableCache(bool enabled);
+	bool isCached(void);
+	bool refresh(void);
+
 	char* dateFormat(const char* dateFormat, RTCDateTime dt);
 	char* dateFormat(const char* dateFormat, RTCAlarmTime dt);
+	size_t dateFormat(char *out, size_t len, const char* dateFormat, const RTCDateTime &dt);
+	size_t dateFormat(char *out, size_t len, const char* dateFormat, const RTCAlarmTime &dt);
+	size_t dateFormat(Print &print, const char* dateFormat, const RTCDateTime &dt);
+	size_t dateFormat(Print &print, const char* dateFormat, const RTCAlarmTime &dt);
 
 	static RTCDateTime loadDateTimeFromLong(uint32_t t);
 
+	static int64_t toEpoch(const RTCDateTime &dt);
+	static RTCDateTime fromEpoch(int64_t t);
+	static RTCDateTime addSeconds(const RTCDateTime &dt, int32_t seconds);
+	static RTCDateTime addDays(const RTCDateTime &dt, int32_t days);
+	static RTCDateTime addMonths(const RTCDateTime &dt, int16_t months);
+	static int64_t diff(const RTCDateTime &a, const RTCDateTime &b);
+	static int8_t compare(const RTCDateTime &a, const RTCDateTime &b);
+
+	static bool isLeapYear(uint16_t year);
+	static uint8_t daysInMonth(uint16_t year, uint8_t month);
+	static uint32_t date2days(uint16_t year, uint8_t month, uint8_t day);
+	static uint32_t unixtime(const RTCDateTime &t);
+
+	static RTCDateTime decodeDateTime(const uint8_t *values);
+	static RTCAlarmTime decodeAlarm1(const uint8_t *values);
+	static DS3231_alarm1_t decodeAlarmType1(const uint8_t *values);
+	static RTCAlarmTime decodeAlarm2(const uint8_t *values);
+	static DS3231_alarm2_t decodeAlarmType2(const uint8_t *values);
+	static int16_t decodeTemperature(uint8_t msb, uint8_t lsb);
+
     private:
 	RTCDateTime t;
 
-	char *strDayOfWeek(uint8_t dayOfWeek);
-	char *strMonth(uint8_t month);
-	char *strAmPm(uint8_t hour, bool uppercase);
-	char *strDaySufix(uint8_t day);
-
-	uint8_t hour12(uint8_t hour24);
-	uint8_t bcd2dec(uint8_t bcd);
-	uint8_t dec2bcd(uint8_t dec);
-
-	long time2long(uint16_t days, uint8_t hours, uint8_t minutes, uint8_t seconds);
-	uint16_t date2days(uint16_t year, uint8_t month, uint8_t day);
-	uint8_t daysInMonth(uint16_t year, uint8_t month);
-	uint16_t dayInYear(uint16_t year, uint8_t month, uint8_t day);
-	bool isLeapYear(uint16_t year);
-	uint8_t dow(uint16_t y, uint8_t m, uint8_t d);
-
-	uint32_t unixtime(void);
-	uint8_t conv2d(const char* p);
+	DS3231TwoWire wireBus;
+	DS3231Bus *bus;
+	uint8_t address;
+
+	bool cached;
+	uint8_t control;
+	uint8_t status;
+
+	volatile uint32_t sqwEdges;
+	volatile uint32_t sqwMicros;
+	volatile uint32_t sqwPeriod;
+	uint32_t sqwBase;
+	uint32_t sqwUnixtime;
+	bool sqwSynced;
+
+	uint32_t setLatency;
+	int32_t setError;
+
+	uint32_t softInterval;
+	uint32_t softLimit;
+	uint32_t softMillis;
+	uint32_t softUnixtime;
+	bool softSynced;
+	uint32_t softHits;
+	uint32_t softMisses;
+
+	DS3231_conversion_t conversion;
+	uint32_t conversionPoll;
+	void (*conversionCallback)(void);
+	bool temperatureRequested;
+
+	static uint8_t bcd2dec(uint8_t bcd);
+	static uint8_t dec2bcd(uint8_t dec);
+
+	static uint32_t time2long(uint32_t days, uint8_t hours, uint8_t minutes, uint8_t seconds);
+	static void days2date(uint32_t days, RTCDateTime &dt);
+	static RTCDateTime fromDays(uint32_t days, uint32_t seconds);
+	static RTCDateTime moveDays(uint32_t base, int32_t days, uint32_t seconds);
+	static uint8_t dow(uint16_t y, uint8_t m, uint8_t d);
+
+	static uint32_t nextAlarmDate(const RTCDateTime &now, const RTCAlarmTime &alarm);
+	static bool parseIso(const char *p, bool strict, RTCDateTime &dt);
+	static bool parseDigits(const char *&p, uint8_t count, uint16_t &value);
+	static bool makeDateTime(uint16_t year, uint8_t month, uint8_t day, uint8_t hour, uint8_t minute, uint8_t second, int32_t offset, RTCDateTime &dt);
+
+	template <class Sink>
+	void format(Sink &sink, const char *dateFormat, const RTCDateTime &dt, bool alarm);
+
+	bool pollConversion(void);
+
+	static void encodeDateTime(uint8_t *values, uint16_t year, uint8_t month, uint8_t day, uint8_t hour, uint8_t minute, uint8_t second);
+	static void encodeAlarm1(uint8_t *values, uint8_t dydw, uint8_t hour, uint8_t minute, uint8_t second, DS3231_alarm1_t mode);
+	static void encodeAlarm2(uint8_t *values, uint8_t dydw, uint8_t hour, uint8_t minute, DS3231_alarm2_t mode);
+	void alarmControl(uint8_t *values, uint8_t alarms, bool armed);
+	void writeAlarmControl(uint8_t alarms, bool armed);
+
+	uint8_t readControl(void);
+	void writeControl(uint8_t value);
+	uint8_t readStatus(void);
+	void writeStatus(uint8_t value);
+	void updateControl(uint8_t control, uint8_t status);
+	void updateStatus(uint8_t value);
 
 	void writeRegister8(uint8_t reg, uint8_t value);
 	uint8_t readRegister8(uint8_t reg);
+	bool writeRegisters(uint8_t reg, const uint8_t *values, uint8_t count);
+	bool readRegisters(uint8_t reg, uint8_t *values, uint8_t count);
 };
 
 #endif
@@ -0,0 +1,96 @@
+/*
+
+The MIT License
+
+Copyright (c) 2014-2023 Korneliusz Jarzębski
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+/*
+
+Build time as a UNIX timestamp, worked out by the compiler.
+
+DS3231_BUILD_TIME(offset) turns __DATE__ and __TIME__ into seconds since
+1970 with constexpr functions, so setting the clock at boot parses nothing:
+
+    clock.setDateTime(DS3231_BUILD_TIME(3600));
+
+__DATE__ and __TIME__ are the local time of the build machine; offset is its
+distance from UTC in seconds, east positive, since the clock keeps UTC.
+The result goes through a template argument, so it is always folded by the
+compiler and offset must be a constant.
+
+*/
+
+#ifndef DS3231BuildTime_h
+#define DS3231BuildTime_h
+
+#include "DS3231.h"
+#include "DS3231Calendar.h"
+
+#define DS3231_BUILD_TIME(offset)   (DS3231BuildTimeConstant<DS3231BuildTime::epoch(__DATE__, __TIME__, (offset))>::value)
+
+template <uint32_t Value>
+struct DS3231BuildTimeConstant
+{
+    static const uint32_t value = Value;
+};
+
+template <uint32_t Value>
+const uint32_t DS3231BuildTimeConstant<Value>::value;
+
+class DS3231BuildTime
+{
+    public:
+
+	static constexpr uint32_t epoch(const char *date, const char *time, int32_t offset)
+	{
+	    return DS3231Calendar::days(year(date), month(date), number(date + 4)) * 86400UL +
+	        number(time) * 3600UL + number(time + 3) * 60UL + number(time + 6) +
+	        DS3231_EPOCH - offset;
+	}
+
+	// "Mmm dd yyyy"
+	static constexpr uint8_t month(const char *date)
+	{
+	    return (date[0] == 'J') ? ((date[1] == 'a') ? 1 : ((date[2] == 'n') ? 6 : 7)) :
+	        (date[0] == 'F') ? 2 :
+	        (date[0] == 'M') ? ((date[2] == 'r') ? 3 : 5) :
+	        (date[0] == 'A') ? ((date[1] == 'p') ? 4 : 8) :
+	        (date[0] == 'S') ? 9 :
+	        (date[0] == 'O') ? 10 :
+	        (date[0] == 'N') ? 11 : 12;
+	}
+
+	static constexpr uint16_t year(const char *date)
+	{
+	    return number(date + 7) * 100 + number(date + 9);
+	}
+
+    private:
+	// Two digits, a leading space counts as zero
+	static constexpr uint8_t number(const char *p)
+	{
+	    return ((p[0] == ' ') ? 0 : (p[0] - '0')) * 10 + (p[1] - '0');
+	}
+};
+
+#endif
@@ -0,0 +1,124 @@
+/*
+
+The MIT License
+
+Copyright (c) 2014-2023 Korneliusz Jarzębski
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+/*
+
+Calendar rules and English names shared by dateFormat() and the compiled
+formats of DS3231Format.h. The rules are constexpr, so constant dates fold
+at compile time.
+
+*/
+
+#ifndef DS3231Calendar_h
+#define DS3231Calendar_h
+
+#if ARDUINO >= 100
+#include "Arduino.h"
+#else
+#include "WProgram.h"
+#endif
+
+class DS3231Calendar
+{
+    public:
+
+	static constexpr bool isLeapYear(uint16_t year)
+	{
+	    return ((year % 4 == 0) && (year % 100 != 0)) || (year % 400 == 0);
+	}
+
+	static constexpr uint8_t daysInMonth(uint16_t year, uint8_t month)
+	{
+	    return (month == 2) ? (isLeapYear(year) ? 29 : 28) :
+	        ((month == 4) || (month == 6) || (month == 9) || (month == 11)) ? 30 : 31;
+	}
+
+	// Zero based, 275 * month / 9 counts the days before a month as if
+	// February had 30
+	static constexpr uint16_t dayInYear(uint16_t year, uint8_t month, uint8_t day)
+	{
+	    return 275 * month / 9 - ((month + 9) / 12) * (isLeapYear(year) ? 1 : 2) + day - 31;
+	}
+
+	// Days since 2000-01-01, valid for 2000-2199.
+	//
+	// Years are counted from March, so the leap day is the last day of a
+	// year and the month lengths repeat with a period of five months
+	// starting from March. Leap years then follow a plain four year cycle
+	// from 1999-03-01, except for 2100 which is corrected by a single
+	// comparison.
+	static constexpr uint32_t days(uint16_t year, uint8_t month, uint8_t day)
+	{
+	    return marchDays(year - 1999 - (month <= 2), (month > 2) ? (month - 3) : (month + 9), day) - 306;
+	}
+
+	static constexpr uint8_t hour12(uint8_t hour)
+	{
+	    return (hour == 0) ? 12 : ((hour > 12) ? hour - 12 : hour);
+	}
+
+	static const char *dayName(uint8_t dayOfWeek)
+	{
+	    static const char *const names[] = { "Unknown", "Monday", "Tuesday",
+	        "Wednesday", "Thursday", "Friday", "Saturday", "Sunday" };
+
+	    return names[dayOfWeek <= 7 ? dayOfWeek : 0];
+	}
+
+	static const char *monthName(uint8_t month)
+	{
+	    static const char *const names[] = { "Unknown", "January", "February",
+	        "March", "April", "May", "June", "July", "August", "September",
+	        "October", "November", "December" };
+
+	    return names[month <= 12 ? month : 0];
+	}
+
+	static const char *daySuffix(uint8_t day)
+	{
+	    static const char *const suffixes[] = { "th", "st", "nd", "rd" };
+
+	    if ((day >= 11 && day <= 13) || (day % 10) > 3)
+	    {
+	        return suffixes[0];
+	    }
+
+	    return suffixes[day % 10];
+	}
+
+	static const char *amPm(uint8_t hour, bool uppercase)
+	{
+	    return (hour < 12) ? (uppercase ? "AM" : "am") : (uppercase ? "PM" : "pm");
+	}
+
+    private:
+	static constexpr uint32_t marchDays(uint8_t y, uint8_t m, uint8_t day)
+	{
+	    return (uint32_t)y * 365 + (y + 3) / 4 + (153 * m + 2) / 5 + day - 1 - (y > 100);
+	}
+};
+
+#endif
@@ -0,0 +1,183 @@
+/*
+
+The MIT License
+
+Copyright (c) 2014-2023 Korneliusz Jarzębski
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "DS3231Calibration.h"
+
+// Windows shorter than this many samples are never trimmed
+#define DS3231_CALIBRATION_MIN_SAMPLES (3)
+
+DS3231Calibration::DS3231Calibration(DS3231 &rtc, uint32_t window, uint8_t tolerance)
+{
+    this->rtc = &rtc;
+    this->window = window;
+    this->tolerance = tolerance;
+
+    calibrated = false;
+    stepCount = 0;
+    stepNext = 0;
+
+    reset();
+}
+
+// Reference time now, the DS3231 is read with now(). Returns true when
+// the aging offset was changed.
+bool DS3231Calibration::addSample(uint32_t unixtime, uint32_t micros)
+{
+    RTCPreciseTime reference;
+
+    reference.unixtime = unixtime;
+    reference.micros = micros;
+
+    return addSample(reference, rtc->now());
+}
+
+bool DS3231Calibration::addSample(const RTCPreciseTime &reference, const RTCPreciseTime &clock)
+{
+    float x;
+    float y;
+    float dx;
+
+    if (!samples)
+    {
+        start = reference.unixtime;
+    }
+
+    // Elapsed reference seconds against the offset in microseconds, so
+    // the slope comes out in ppm
+    x = (float)(reference.unixtime - start) + reference.micros / 1000000.0f;
+    y = (float)(int32_t)(clock.unixtime - reference.unixtime) * 1000000.0f + ((float)clock.micros - (float)reference.micros);
+
+    // Welford's running sums stay accurate over long windows
+    ++samples;
+    dx = x - meanX;
+    meanX += dx / samples;
+    meanY += (y - meanY) / samples;
+    sxx += dx * (x - meanX);
+    sxy += dx * (y - meanY);
+
+    span = reference.unixtime - start;
+
+    if ((span < window) || (samples < DS3231_CALIBRATION_MIN_SAMPLES))
+    {
+        return false;
+    }
+
+    return finishWindow(reference.unixtime);
+}
+
+float DS3231Calibration::getDrift(void)
+{
+    return (sxx > 0) ? (sxy / sxx) : 0;
+}
+
+uint32_t DS3231Calibration::getSpan(void)
+{
+    return span;
+}
+
+uint16_t DS3231Calibration::getSamples(void)
+{
+    return samples;
+}
+
+// True once a full window stayed within tolerance
+bool DS3231Calibration::isCalibrated(void)
+{
+    return calibrated;
+}
+
+uint8_t DS3231Calibration::getSteps(void)
+{
+    return stepCount;
+}
+
+// Index 0 is the most recent window
+DS3231CalibrationStep DS3231Calibration::getStep(uint8_t index)
+{
+    uint8_t i = (stepNext + DS3231_CALIBRATION_HISTORY - 1 - index) % DS3231_CALIBRATION_HISTORY;
+
+    return steps[i];
+}
+
+void DS3231Calibration::reset(void)
+{
+    start = 0;
+    span = 0;
+    samples = 0;
+    meanX = 0;
+    meanY = 0;
+    sxx = 0;
+    sxy = 0;
+}
+
+// Trims the aging offset if needed and starts the next window. Returns
+// true when the offset was changed. A changed offset is applied by a
+// conversion run to completion, up to 200 ms, so the next window starts
+// on the new frequency and the conversion state machine is left idle.
+bool DS3231Calibration::finishWindow(uint32_t unixtime)
+{
+    float drift = getDrift();
+    int8_t aging = rtc->getAging();
+    int16_t trim;
+    bool changed;
+    DS3231CalibrationStep &step = steps[stepNext];
+
+    // A fast clock has a positive drift and needs a larger offset
+    trim = aging + (int16_t)(drift * 10.0f + ((drift < 0) ? -0.5f : 0.5f));
+
+    if (trim > 127)
+    {
+        trim = 127;
+    } else if (trim < -128)
+    {
+        trim = -128;
+    }
+
+    calibrated = (drift * 10.0f <= tolerance) && (drift * 10.0f >= -tolerance);
+
+    changed = !calibrated && (trim != aging);
+
+    if (changed)
+    {
+        rtc->setAging(trim);
+        rtc->forceConversion();
+    }
+
+    step.unixtime = unixtime;
+    step.error = (int16_t)(drift * 100.0f);
+    step.aging = calibrated ? aging : trim;
+
+    stepNext = (stepNext + 1) % DS3231_CALIBRATION_HISTORY;
+
+    if (stepCount < DS3231_CALIBRATION_HISTORY)
+    {
+        ++stepCount;
+    }
+
+    reset();
+
+    return changed;
+}
@@ -0,0 +1,101 @@
+/*
+
+The MIT License
+
+Copyright (c) 2014-2023 Korneliusz Jarzębski
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+/*
+
+Closed loop calibration of the aging offset against a reference clock.
+
+Every addSample() pairs a reference time, e.g. received over Serial or
+from GPS, with the DS3231 time read at the same moment. The offset between
+the two is fitted against elapsed time by least squares, kept as running
+sums, so a window can span weeks in a few bytes. The slope is the drift in
+ppm. Once a window spans the configured length, a drift above the
+tolerance is trimmed with the aging offset (0.1 ppm per step), the
+chip applies it in a forced conversion, and a fresh window verifies the
+result. The last DS3231_CALIBRATION_HISTORY windows are kept.
+
+With enablePreciseClock() samples have microsecond resolution. Without it
+the DS3231 side is whole seconds, and windows need to be much longer.
+
+*/
+
+#ifndef DS3231Calibration_h
+#define DS3231Calibration_h
+
+#include "DS3231.h"
+
+#define DS3231_CALIBRATION_HISTORY  (8)
+
+struct DS3231CalibrationStep
+{
+    uint32_t unixtime;
+    int16_t error;
+    int8_t aging;
+};
+
+class DS3231Calibration
+{
+    public:
+
+	DS3231Calibration(DS3231 &rtc, uint32_t window = 86400, uint8_t tolerance = 1);
+
+	bool addSample(uint32_t unixtime, uint32_t micros);
+	bool addSample(const RTCPreciseTime &reference, const RTCPreciseTime &clock);
+
+	float getDrift(void);
+	uint32_t getSpan(void);
+	uint16_t getSamples(void);
+	bool isCalibrated(void);
+
+	uint8_t getSteps(void);
+	DS3231CalibrationStep getStep(uint8_t index);
+
+	void reset(void);
+
+    private:
+	DS3231 *rtc;
+
+	uint32_t window;
+	uint8_t tolerance;
+
+	uint32_t start;
+	uint32_t span;
+	uint16_t samples;
+	float meanX;
+	float meanY;
+	float sxx;
+	float sxy;
+
+	bool calibrated;
+
+	DS3231CalibrationStep steps[DS3231_CALIBRATION_HISTORY];
+	uint8_t stepCount;
+	uint8_t stepNext;
+
+	bool finishWindow(uint32_t unixtime);
+};
+
+#endif
@@ -0,0 +1,422 @@
+/*
+
+The MIT License
+
+Copyright (c) 2014-2023 Korneliusz Jarzębski
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "DS3231Cron.h"
+
+DS3231Cron::DS3231Cron(void)
+{
+    parse("* * * * *");
+}
+
+bool DS3231Cron::parse(const char *expression)
+{
+    uint64_t bits[5];
+    bool any[5];
+    const char *p = expression;
+
+    static const uint8_t limits[5][2] = { { 0, 59 }, { 0, 23 }, { 1, 31 }, { 1, 12 }, { 0, 7 } };
+
+    for (uint8_t i = 0; i < 5; ++i)
+    {
+        while (*p == ' ' || *p == '\t')
+        {
+            ++p;
+        }
+
+        if (!parseField(p, bits[i], limits[i][0], limits[i][1], any[i]))
+        {
+            return false;
+        }
+    }
+
+    while (*p == ' ' || *p == '\t')
+    {
+        ++p;
+    }
+
+    if (*p != '\0')
+    {
+        return false;
+    }
+
+    minutes = bits[0];
+    hours = bits[1];
+    days = bits[2];
+    months = bits[3];
+
+    // Sunday is both 0 and 7
+    weekdays = (bits[4] | (bits[4] >> 7)) & 0b01111111;
+
+    anyDay = any[2];
+    anyWeekday = any[4];
+
+    compile();
+
+    return true;
+}
+
+bool DS3231Cron::matches(const RTCDateTime &dt)
+{
+    return ((minutes >> dt.minute) & 1) && ((hours >> dt.hour) & 1) &&
+        ((months >> dt.month) & 1) && matchesDay(dt);
+}
+
+// Returns the first fire time after the given unixtime, or 0 if the
+// schedule never fires, like "0 0 30 2 *". Whole days, then hours, are
+// skipped while they cannot match.
+uint32_t DS3231Cron::next(uint32_t after)
+{
+    uint32_t t = after - (after % 60) + 60;
+    uint16_t skippedDays = 0;
+
+    for (;;)
+    {
+        RTCDateTime dt = DS3231::loadDateTimeFromLong(t);
+
+        if (!((months >> dt.month) & 1) || !matchesDay(dt))
+        {
+            // Eight years covers every leap day and weekday combination
+            if (++skippedDays > 8 * 366)
+            {
+                return 0;
+            }
+
+            t += 86400UL - (dt.hour * 3600UL) - (dt.minute * 60UL);
+            continue;
+        }
+
+        if (!((hours >> dt.hour) & 1))
+        {
+            t += 3600UL - (dt.minute * 60UL);
+            continue;
+        }
+
+        if (!((minutes >> dt.minute) & 1))
+        {
+            t += 60;
+            continue;
+        }
+
+        return t;
+    }
+}
+
+bool DS3231Cron::needsRearm(void)
+{
+    return !native;
+}
+
+// The alarm 1 mode is the alarm 2 mode with the seconds matched at 0
+DS3231_alarm1_t DS3231Cron::getAlarmType1(void)
+{
+    switch (mode)
+    {
+        case DS3231_EVERY_MINUTE:
+            return DS3231_MATCH_S;
+        case DS3231_MATCH_M:
+            return DS3231_MATCH_M_S;
+        case DS3231_MATCH_H_M:
+            return DS3231_MATCH_H_M_S;
+        case DS3231_MATCH_DY_H_M:
+            return DS3231_MATCH_DY_H_M_S;
+        default:
+            return DS3231_MATCH_DT_H_M_S;
+    }
+}
+
+DS3231_alarm2_t DS3231Cron::getAlarmType2(void)
+{
+    return mode;
+}
+
+bool DS3231Cron::setAlarm1(DS3231 &rtc, uint32_t now, bool armed)
+{
+    RTCAlarmTime alarm;
+
+    if (!getAlarm(now, alarm))
+    {
+        return false;
+    }
+
+    rtc.setAlarm1(alarm.day, alarm.hour, alarm.minute, 0, getAlarmType1(), armed);
+
+    return true;
+}
+
+bool DS3231Cron::setAlarm2(DS3231 &rtc, uint32_t now, bool armed)
+{
+    RTCAlarmTime alarm;
+
+    if (!getAlarm(now, alarm))
+    {
+        return false;
+    }
+
+    rtc.setAlarm2(alarm.day, alarm.hour, alarm.minute, mode, armed);
+
+    return true;
+}
+
+bool DS3231Cron::matchesDay(const RTCDateTime &dt)
+{
+    bool day = (days >> dt.day) & 1;
+    bool weekday = (weekdays >> (dt.dayOfWeek % 7)) & 1;
+
+    if (anyDay || anyWeekday)
+    {
+        return day && weekday;
+    }
+
+    return day || weekday;
+}
+
+// Native schedules only fill in the fields their mode matches. Everything
+// else gets the next fire time with a date match. A fire time more than a
+// month ahead can match a date early, matches() tells the two apart.
+bool DS3231Cron::getAlarm(uint32_t now, RTCAlarmTime &alarm)
+{
+    if (native)
+    {
+        alarm.second = 0;
+        alarm.minute = (mode == DS3231_EVERY_MINUTE) ? 0 : single(minutes);
+        alarm.hour = (mode == DS3231_EVERY_MINUTE || mode == DS3231_MATCH_M) ? 0 : single(hours);
+
+        if (mode == DS3231_MATCH_DT_H_M)
+        {
+            alarm.day = single(days);
+        } else if (mode == DS3231_MATCH_DY_H_M)
+        {
+            // The chip counts weekdays from 1 for Monday to 7 for Sunday
+            alarm.day = single(weekdays) ? single(weekdays) : 7;
+        } else
+        {
+            alarm.day = 0;
+        }
+
+        return true;
+    }
+
+    uint32_t t = next(now);
+
+    if (!t)
+    {
+        return false;
+    }
+
+    RTCDateTime dt = DS3231::loadDateTimeFromLong(t);
+
+    alarm.day = dt.day;
+    alarm.hour = dt.hour;
+    alarm.minute = dt.minute;
+    alarm.second = 0;
+
+    return true;
+}
+
+void DS3231Cron::compile(void)
+{
+    bool everyMonth = isFull(months, 1, 12);
+    bool everyHour = isFull(hours, 0, 23);
+    bool everyMinute = isFull(minutes, 0, 59);
+    bool everyDay = isFull(days, 1, 31);
+    bool everyWeekday = isFull(weekdays, 0, 6);
+    bool either = !anyDay && !anyWeekday;
+    int8_t minute = single(minutes);
+    int8_t hour = single(hours);
+
+    native = false;
+    mode = DS3231_MATCH_DT_H_M;
+
+    if (!everyMonth)
+    {
+        return;
+    }
+
+    // The * flags only pick between the AND and OR day rules, "*/2" is
+    // not every day
+    if (either ? (everyDay || everyWeekday) : (everyDay && everyWeekday))
+    {
+        if (everyMinute && everyHour)
+        {
+            mode = DS3231_EVERY_MINUTE;
+            native = true;
+        } else if ((minute >= 0) && everyHour)
+        {
+            mode = DS3231_MATCH_M;
+            native = true;
+        } else if ((minute >= 0) && (hour >= 0))
+        {
+            mode = DS3231_MATCH_H_M;
+            native = true;
+        }
+
+        return;
+    }
+
+    // Two restricted fields fire on either, which no single match covers
+    if ((minute < 0) || (hour < 0) || either)
+    {
+        return;
+    }
+
+    if (everyWeekday && (single(days) >= 0))
+    {
+        mode = DS3231_MATCH_DT_H_M;
+        native = true;
+    } else if (everyDay && (single(weekdays) >= 0))
+    {
+        mode = DS3231_MATCH_DY_H_M;
+        native = true;
+    }
+}
+
+// Parses one field into a bitmask indexed by value, "*" sets any
+bool DS3231Cron::parseField(const char *&p, uint64_t &bits, uint8_t min, uint8_t max, bool &any)
+{
+    bits = 0;
+    any = (*p == '*');
+
+    for (;;)
+    {
+        uint8_t from = min;
+        uint8_t to = max;
+        uint8_t step = 1;
+
+        if (*p == '*')
+        {
+            ++p;
+        } else
+        {
+            if (!parseNumber(p, from))
+            {
+                return false;
+            }
+
+            to = from;
+
+            if (*p == '-')
+            {
+                ++p;
+
+                if (!parseNumber(p, to))
+                {
+                    return false;
+                }
+            }
+        }
+
+        if (*p == '/')
+        {
+            ++p;
+
+            if (!parseNumber(p, step) || !step)
+            {
+                return false;
+            }
+
+            // "5/15" runs from 5 to the end of the range
+            if (to == from)
+            {
+                to = max;
+            }
+        }
+
+        if ((from < min) || (to > max) || (from > to))
+        {
+            return false;
+        }
+
+        for (uint16_t i = from; i <= to; i += step)
+        {
+            bits |= (uint64_t)1 << i;
+        }
+
+        if (*p != ',')
+        {
+            break;
+        }
+
+        ++p;
+    }
+
+    return (*p == ' ' || *p == '\t' || *p == '\0');
+}
+
+bool DS3231Cron::parseNumber(const char *&p, uint8_t &value)
+{
+    uint16_t number = 0;
+
+    if (*p < '0' || *p > '9')
+    {
+        return false;
+    }
+
+    while (*p >= '0' && *p <= '9')
+    {
+        number = number * 10 + (*p++ - '0');
+
+        if (number > 255)
+        {
+            return false;
+        }
+    }
+
+    value = number;
+
+    return true;
+}
+
+// Index of the only set bit, or -1
+int8_t DS3231Cron::single(uint64_t bits)
+{
+    int8_t index = 0;
+
+    if (!bits || (bits & (bits - 1)))
+    {
+        return -1;
+    }
+
+    while (!(bits & 1))
+    {
+        bits >>= 1;
+        ++index;
+    }
+
+    return index;
+}
+
+bool DS3231Cron::isFull(uint64_t bits, uint8_t min, uint8_t max)
+{
+    for (uint8_t i = min; i <= max; ++i)
+    {
+        if (!((bits >> i) & 1))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,89 @@
+/*
+
+The MIT License
+
+Copyright (c) 2014-2023 Korneliusz Jarzębski
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+/*
+
+Cron schedules for the DS3231 alarms.
+
+parse() takes the five usual fields, "minute hour day month weekday". Each
+is a comma separated list of *, n or n-m, any of them followed by an
+optional /step, so "0-59/15 8-18 * * 1-5" fires every quarter hour during
+working hours. Weekdays run 0 to 7, both 0 and 7 being Sunday. As in cron,
+when neither day nor weekday is *, a day matching either one fires.
+
+Schedules the chip repeats on its own, such as "30 * * * *" or
+"0 7 * * 1", are programmed once with the matching alarm mode and never
+need rewriting. Any other schedule is programmed one fire time at a time,
+and needsRearm() reports it so the caller sets it again after each alarm.
+
+*/
+
+#ifndef DS3231Cron_h
+#define DS3231Cron_h
+
+#include "DS3231.h"
+
+class DS3231Cron
+{
+    public:
+
+	DS3231Cron(void);
+
+	bool parse(const char *expression);
+
+	bool matches(const RTCDateTime &dt);
+	uint32_t next(uint32_t after);
+
+	bool needsRearm(void);
+	DS3231_alarm1_t getAlarmType1(void);
+	DS3231_alarm2_t getAlarmType2(void);
+
+	bool setAlarm1(DS3231 &rtc, uint32_t now, bool armed = true);
+	bool setAlarm2(DS3231 &rtc, uint32_t now, bool armed = true);
+
+    private:
+	uint64_t minutes;
+	uint32_t hours;
+	uint32_t days;
+	uint16_t months;
+	uint8_t weekdays;
+	bool anyDay;
+	bool anyWeekday;
+
+	bool native;
+	DS3231_alarm2_t mode;
+
+	bool matchesDay(const RTCDateTime &dt);
+	bool getAlarm(uint32_t now, RTCAlarmTime &alarm);
+	void compile(void);
+
+	static bool parseField(const char *&p, uint64_t &bits, uint8_t min, uint8_t max, bool &any);
+	static bool parseNumber(const char *&p, uint8_t &value);
+	static int8_t single(uint64_t bits);
+	static bool isFull(uint64_t bits, uint8_t min, uint8_t max);
+};
+
+#endif
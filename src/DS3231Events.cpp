@@ -0,0 +1,154 @@
+/*
+
+The MIT License
+
+Copyright (c) 2014-2023 Korneliusz Jarzębski
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "DS3231Events.h"
+
+DS3231Events::DS3231Events(DS3231 &rtc, uint32_t *buffer, uint8_t size)
+{
+    this->rtc = &rtc;
+
+    // Round down to a power of two, without any room every edge overflows
+    while (size & (size - 1))
+    {
+        size &= size - 1;
+    }
+
+    this->buffer = size ? buffer : 0;
+
+    mask = size ? size - 1 : 0;
+
+    head = 0;
+    tail = 0;
+
+    handler1 = 0;
+    handler2 = 0;
+
+    maxLatency = 0;
+    overflows = 0;
+}
+
+void DS3231Events::setHandler1(void (*handler)(uint32_t stamp))
+{
+    handler1 = handler;
+}
+
+void DS3231Events::setHandler2(void (*handler)(uint32_t stamp))
+{
+    handler2 = handler;
+}
+
+// Producer side. Only head is written here, and only after the stamp is
+// stored, so the consumer never sees a half written entry.
+void DS3231Events::handleInterrupt(void)
+{
+    uint8_t next = head;
+
+    if (!buffer || ((uint8_t)(next - tail) > mask))
+    {
+        ++overflows;
+        return;
+    }
+
+    buffer[next & mask] = micros();
+
+    head = next + 1;
+}
+
+uint8_t DS3231Events::available(void)
+{
+    return head - tail;
+}
+
+// Consumer side, returns the number of edges handled
+uint8_t DS3231Events::process(void)
+{
+    uint8_t count = 0;
+
+    while (tail != head)
+    {
+        uint32_t stamp = buffer[tail & mask];
+        uint8_t flags = 0;
+        uint8_t raised;
+        uint32_t latency;
+
+        tail = tail + 1;
+
+        // INT is level triggered. A flag raised between the STATUS read and
+        // its write back stays set and brings no new edge, so poll until a
+        // read finds none.
+        do
+        {
+            raised = rtc->pollAlarms(DS3231_ALARM_1 | DS3231_ALARM_2) & (DS3231_ALARM_1 | DS3231_ALARM_2);
+            flags |= raised;
+        } while (raised);
+
+        latency = micros() - stamp;
+
+        if (latency > maxLatency)
+        {
+            maxLatency = latency;
+        }
+
+        if ((flags & DS3231_ALARM_1) && handler1)
+        {
+            handler1(stamp);
+        }
+
+        if ((flags & DS3231_ALARM_2) && handler2)
+        {
+            handler2(stamp);
+        }
+
+        ++count;
+    }
+
+    return count;
+}
+
+uint32_t DS3231Events::getMaxLatency(void)
+{
+    return maxLatency;
+}
+
+uint32_t DS3231Events::getOverflows(void)
+{
+    uint32_t value;
+
+    noInterrupts();
+    value = overflows;
+    interrupts();
+
+    return value;
+}
+
+void DS3231Events::resetStatistics(void)
+{
+    maxLatency = 0;
+
+    noInterrupts();
+    overflows = 0;
+    interrupts();
+}
@@ -0,0 +1,81 @@
+/*
+
+The MIT License
+
+Copyright (c) 2014-2023 Korneliusz Jarzębski
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+/*
+
+Alarm interrupts queued from the ISR and handled in loop().
+
+handleInterrupt() only stores a micros() stamp of the INT edge in a
+single producer, single consumer ring, so it is safe to call from the ISR.
+process() runs from loop(): for every queued edge it reads STATUS,
+acknowledges the alarms that fired and reads again until no alarm flag is
+left, so an edge costs at least two reads. Then it calls the handlers with
+the edge stamp. The ring size is rounded down to a power of two, so 12
+entries use 8 and a size of 0 queues nothing. Edges arriving while it is
+full are counted by getOverflows(), and getMaxLatency() holds the longest
+time from an edge to its handler.
+
+*/
+
+#ifndef DS3231Events_h
+#define DS3231Events_h
+
+#include "DS3231.h"
+
+class DS3231Events
+{
+    public:
+
+	DS3231Events(DS3231 &rtc, uint32_t *buffer, uint8_t size);
+
+	void setHandler1(void (*handler)(uint32_t stamp));
+	void setHandler2(void (*handler)(uint32_t stamp));
+
+	void handleInterrupt(void);
+	uint8_t available(void);
+	uint8_t process(void);
+
+	uint32_t getMaxLatency(void);
+	uint32_t getOverflows(void);
+	void resetStatistics(void);
+
+    private:
+	DS3231 *rtc;
+
+	volatile uint32_t *buffer;
+	uint8_t mask;
+
+	volatile uint8_t head;
+	volatile uint8_t tail;
+
+	void (*handler1)(uint32_t stamp);
+	void (*handler2)(uint32_t stamp);
+
+	uint32_t maxLatency;
+	volatile uint32_t overflows;
+};
+
+#endif
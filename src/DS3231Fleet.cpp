@@ -0,0 +1,144 @@
+/*
+
+The MIT License
+
+Copyright (c) 2014-2023 Korneliusz Jarzębski
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "DS3231Fleet.h"
+
+DS3231Fleet::DS3231Fleet(uint8_t tolerance)
+{
+    this->tolerance = tolerance;
+    count = 0;
+    responding = 0;
+    agreeing = 0;
+    median = DS3231_EPOCH;
+    reverse = false;
+}
+
+bool DS3231Fleet::add(DS3231 &rtc)
+{
+    if (count >= DS3231_FLEET_MAX)
+    {
+        return false;
+    }
+
+    clocks[count++] = &rtc;
+
+    return true;
+}
+
+uint8_t DS3231Fleet::getCount(void)
+{
+    return count;
+}
+
+// Returns the number of clocks that answered
+uint8_t DS3231Fleet::read(void)
+{
+    uint32_t sorted[DS3231_FLEET_MAX];
+    RTCDateTime dt;
+    uint8_t n = 0;
+    uint8_t j;
+
+    responding = 0;
+    agreeing = 0;
+
+    for (uint8_t i = 0; i < count; ++i)
+    {
+        uint8_t index = reverse ? (count - 1 - i) : i;
+
+        if (clocks[index]->readDateTime(dt))
+        {
+            times[index] = dt.unixtime;
+            responding |= 1 << index;
+
+            // Insertion sort, at most DS3231_FLEET_MAX values
+            j = n++;
+
+            while ((j > 0) && (sorted[j - 1] > times[index]))
+            {
+                sorted[j] = sorted[j - 1];
+                --j;
+            }
+
+            sorted[j] = times[index];
+        }
+    }
+
+    reverse = !reverse;
+
+    if (n == 0)
+    {
+        return 0;
+    }
+
+    median = sorted[(n - 1) / 2];
+
+    for (uint8_t i = 0; i < count; ++i)
+    {
+        if (isResponding(i) && (((times[i] > median) ? (times[i] - median) : (median - times[i])) <= tolerance))
+        {
+            agreeing |= 1 << i;
+        }
+    }
+
+    return n;
+}
+
+RTCDateTime DS3231Fleet::getMedian(void)
+{
+    return DS3231::loadDateTimeFromLong(median);
+}
+
+uint8_t DS3231Fleet::getAgreeing(void)
+{
+    uint8_t n = 0;
+
+    for (uint8_t i = 0; i < count; ++i)
+    {
+        n += isAgreeing(i);
+    }
+
+    return n;
+}
+
+bool DS3231Fleet::hasConsensus(void)
+{
+    return (getAgreeing() * 2 > count);
+}
+
+bool DS3231Fleet::isResponding(uint8_t index)
+{
+    return (responding >> index) & 1;
+}
+
+bool DS3231Fleet::isAgreeing(uint8_t index)
+{
+    return (agreeing >> index) & 1;
+}
+
+uint32_t DS3231Fleet::getUnixtime(uint8_t index)
+{
+    return times[index];
+}
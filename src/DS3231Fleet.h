@@ -0,0 +1,81 @@
+/*
+
+The MIT License
+
+Copyright (c) 2014-2023 Korneliusz Jarzębski
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+/*
+
+Redundant DS3231 clocks read as one.
+
+read() takes the time registers of every added clock in one 7 byte burst
+each. All of them answer at 0x68, so behind a multiplexer every clock costs
+one channel switch; the order alternates between reads so the clock read
+last is read first the next time, saving the switch to its channel.
+
+getMedian() is the median of the clocks that answered, the lower of the two
+middle ones for an even count, so it is always a real reading. Clocks within
+tolerance seconds of it agree, and hasConsensus() needs more than half of
+all added clocks to agree.
+
+*/
+
+#ifndef DS3231Fleet_h
+#define DS3231Fleet_h
+
+#include "DS3231.h"
+
+#define DS3231_FLEET_MAX            (8)
+
+class DS3231Fleet
+{
+    public:
+
+	DS3231Fleet(uint8_t tolerance = 1);
+
+	bool add(DS3231 &rtc);
+	uint8_t getCount(void);
+
+	uint8_t read(void);
+
+	RTCDateTime getMedian(void);
+	uint8_t getAgreeing(void);
+	bool hasConsensus(void);
+
+	bool isResponding(uint8_t index);
+	bool isAgreeing(uint8_t index);
+	uint32_t getUnixtime(uint8_t index);
+
+    private:
+	DS3231 *clocks[DS3231_FLEET_MAX];
+	uint32_t times[DS3231_FLEET_MAX];
+	uint8_t count;
+	uint8_t tolerance;
+
+	uint8_t responding;
+	uint8_t agreeing;
+	uint32_t median;
+	bool reverse;
+};
+
+#endif
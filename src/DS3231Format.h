@@ -0,0 +1,271 @@
+/*
+
+The MIT License
+
+Copyright (c) 2014-2023 Korneliusz Jarzębski
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+/*
+
+Date formats compiled at build time.
+
+DS3231_FORMAT("d-m-Y H:i:s") names a type that formats an RTCDateTime with
+the dateFormat() grammar, unrolled into one write per specifier:
+
+    typedef DS3231_FORMAT("d-m-Y H:i:s") LogFormat;
+
+    char buffer[LogFormat::size];
+    LogFormat::format(buffer, dt);
+
+size is the longest possible output plus the terminating NUL, so the buffer
+never needs checking. The output length is exact when the format only uses
+fixed width specifiers. Letters that are not specifiers fail to compile;
+write them as "\\T" to get a literal letter. Formats are limited to
+DS3231_FORMAT_MAX characters.
+
+*/
+
+#ifndef DS3231Format_h
+#define DS3231Format_h
+
+#include "DS3231.h"
+#include "DS3231Calendar.h"
+
+#define DS3231_FORMAT_MAX           (32)
+
+class DS3231FormatWriter
+{
+    public:
+
+	static char *str(char *p, const char *s, uint8_t max)
+	{
+	    while (*s && max--)
+	    {
+	        *p++ = *s++;
+	    }
+
+	    return p;
+	}
+
+	static char *fixed(char *p, uint32_t value, uint8_t width)
+	{
+	    for (uint8_t i = width; i > 0; --i)
+	    {
+	        p[i - 1] = '0' + (value % 10);
+	        value /= 10;
+	    }
+
+	    return p + width;
+	}
+
+	static char *number(char *p, uint32_t value)
+	{
+	    uint8_t width = 1;
+
+	    for (uint32_t v = value; v >= 10; v /= 10)
+	    {
+	        ++width;
+	    }
+
+	    return fixed(p, value, width);
+	}
+};
+
+// Anything but a letter is copied literally
+template <char C>
+struct DS3231FormatToken
+{
+    static_assert(!((C >= 'a' && C <= 'z') || (C >= 'A' && C <= 'Z')), "Unknown dateFormat specifier");
+
+    static const uint8_t width = 1;
+
+    static char *write(char *p, const RTCDateTime &)
+    {
+        *p = C;
+
+        return p + 1;
+    }
+};
+
+#define DS3231_FORMAT_TOKEN(c, w, expression) \
+template <> \
+struct DS3231FormatToken<c> \
+{ \
+    static const uint8_t width = w; \
+\
+    static char *write(char *p, const RTCDateTime &dt) \
+    { \
+        return expression; \
+    } \
+};
+
+// Day decoder
+DS3231_FORMAT_TOKEN('d', 2, DS3231FormatWriter::fixed(p, dt.day, 2))
+DS3231_FORMAT_TOKEN('j', 2, DS3231FormatWriter::number(p, dt.day))
+DS3231_FORMAT_TOKEN('l', 9, DS3231FormatWriter::str(p, DS3231Calendar::dayName(dt.dayOfWeek), 9))
+DS3231_FORMAT_TOKEN('D', 3, DS3231FormatWriter::str(p, DS3231Calendar::dayName(dt.dayOfWeek), 3))
+DS3231_FORMAT_TOKEN('N', 1, DS3231FormatWriter::fixed(p, dt.dayOfWeek, 1))
+DS3231_FORMAT_TOKEN('w', 1, DS3231FormatWriter::fixed(p, (dt.dayOfWeek + 7) % 7, 1))
+DS3231_FORMAT_TOKEN('z', 3, DS3231FormatWriter::number(p, DS3231Calendar::dayInYear(dt.year, dt.month, dt.day)))
+DS3231_FORMAT_TOKEN('S', 2, DS3231FormatWriter::str(p, DS3231Calendar::daySuffix(dt.day), 2))
+
+// Month decoder
+DS3231_FORMAT_TOKEN('m', 2, DS3231FormatWriter::fixed(p, dt.month, 2))
+DS3231_FORMAT_TOKEN('n', 2, DS3231FormatWriter::number(p, dt.month))
+DS3231_FORMAT_TOKEN('F', 9, DS3231FormatWriter::str(p, DS3231Calendar::monthName(dt.month), 9))
+DS3231_FORMAT_TOKEN('M', 3, DS3231FormatWriter::str(p, DS3231Calendar::monthName(dt.month), 3))
+DS3231_FORMAT_TOKEN('t', 2, DS3231FormatWriter::fixed(p, DS3231Calendar::daysInMonth(dt.year, dt.month), 2))
+
+// Year decoder
+DS3231_FORMAT_TOKEN('Y', 4, DS3231FormatWriter::fixed(p, dt.year, 4))
+DS3231_FORMAT_TOKEN('y', 2, DS3231FormatWriter::fixed(p, dt.year % 100, 2))
+DS3231_FORMAT_TOKEN('L', 1, DS3231FormatWriter::fixed(p, DS3231Calendar::isLeapYear(dt.year), 1))
+
+// Hour decoder
+DS3231_FORMAT_TOKEN('H', 2, DS3231FormatWriter::fixed(p, dt.hour, 2))
+DS3231_FORMAT_TOKEN('G', 2, DS3231FormatWriter::number(p, dt.hour))
+DS3231_FORMAT_TOKEN('h', 2, DS3231FormatWriter::fixed(p, DS3231Calendar::hour12(dt.hour), 2))
+DS3231_FORMAT_TOKEN('g', 2, DS3231FormatWriter::number(p, DS3231Calendar::hour12(dt.hour)))
+DS3231_FORMAT_TOKEN('A', 2, DS3231FormatWriter::str(p, DS3231Calendar::amPm(dt.hour, true), 2))
+DS3231_FORMAT_TOKEN('a', 2, DS3231FormatWriter::str(p, DS3231Calendar::amPm(dt.hour, false), 2))
+
+// Minute decoder
+DS3231_FORMAT_TOKEN('i', 2, DS3231FormatWriter::fixed(p, dt.minute, 2))
+
+// Second decoder
+DS3231_FORMAT_TOKEN('s', 2, DS3231FormatWriter::fixed(p, dt.second, 2))
+
+// Misc decoder
+DS3231_FORMAT_TOKEN('U', 10, DS3231FormatWriter::number(p, dt.unixtime))
+
+#undef DS3231_FORMAT_TOKEN
+
+// Entry points shared by every compiled format
+template <class Format>
+struct DS3231FormatCompiled
+{
+    // Writes the NUL terminated result, out must hold Format::size bytes
+    static size_t format(char *out, const RTCDateTime &dt)
+    {
+        char *p = Format::write(out, dt);
+
+        *p = '\0';
+
+        return p - out;
+    }
+
+    static size_t print(Print &print, const RTCDateTime &dt)
+    {
+        char buffer[Format::size];
+
+        return print.write((const uint8_t *)buffer, format(buffer, dt));
+    }
+};
+
+template <char... Chars>
+struct DS3231Format;
+
+template <>
+struct DS3231Format<> : DS3231FormatCompiled<DS3231Format<> >
+{
+    static const size_t length = 0;
+    static const size_t size = 1;
+
+    static char *write(char *p, const RTCDateTime &)
+    {
+        return p;
+    }
+};
+
+template <char C, char... Rest>
+struct DS3231Format<C, Rest...> : DS3231FormatCompiled<DS3231Format<C, Rest...> >
+{
+    static const size_t length = DS3231FormatToken<C>::width + DS3231Format<Rest...>::length;
+    static const size_t size = length + 1;
+
+    static char *write(char *p, const RTCDateTime &dt)
+    {
+        return DS3231Format<Rest...>::write(DS3231FormatToken<C>::write(p, dt), dt);
+    }
+};
+
+// Escaped character, copied literally
+template <char C, char... Rest>
+struct DS3231Format<'\\', C, Rest...> : DS3231FormatCompiled<DS3231Format<'\\', C, Rest...> >
+{
+    static const size_t length = 1 + DS3231Format<Rest...>::length;
+    static const size_t size = length + 1;
+
+    static char *write(char *p, const RTCDateTime &dt)
+    {
+        *p = C;
+
+        return DS3231Format<Rest...>::write(p + 1, dt);
+    }
+};
+
+// Collects the characters of the literal up to its terminating NUL
+template <class Format, char... Chars>
+struct DS3231FormatBuilder;
+
+template <char... Format>
+struct DS3231FormatBuilder<DS3231Format<Format...> >
+{
+    typedef DS3231Format<Format...> type;
+};
+
+template <char... Format, char... Chars>
+struct DS3231FormatBuilder<DS3231Format<Format...>, '\0', Chars...>
+{
+    typedef DS3231Format<Format...> type;
+};
+
+template <char... Format, char C, char... Chars>
+struct DS3231FormatBuilder<DS3231Format<Format...>, C, Chars...>
+{
+    typedef typename DS3231FormatBuilder<DS3231Format<Format..., C>, Chars...>::type type;
+};
+
+template <size_t Length, class Format>
+struct DS3231FormatChecked
+{
+    static_assert(Length <= DS3231_FORMAT_MAX, "dateFormat longer than DS3231_FORMAT_MAX");
+
+    typedef Format type;
+};
+
+#define DS3231_FORMAT_AT(s, i) ((i) < sizeof(s) ? (s)[(i) < sizeof(s) ? (i) : 0] : '\0')
+
+#define DS3231_FORMAT_CHARS(s) \
+    DS3231_FORMAT_AT(s,  0), DS3231_FORMAT_AT(s,  1), DS3231_FORMAT_AT(s,  2), DS3231_FORMAT_AT(s,  3), \
+    DS3231_FORMAT_AT(s,  4), DS3231_FORMAT_AT(s,  5), DS3231_FORMAT_AT(s,  6), DS3231_FORMAT_AT(s,  7), \
+    DS3231_FORMAT_AT(s,  8), DS3231_FORMAT_AT(s,  9), DS3231_FORMAT_AT(s, 10), DS3231_FORMAT_AT(s, 11), \
+    DS3231_FORMAT_AT(s, 12), DS3231_FORMAT_AT(s, 13), DS3231_FORMAT_AT(s, 14), DS3231_FORMAT_AT(s, 15), \
+    DS3231_FORMAT_AT(s, 16), DS3231_FORMAT_AT(s, 17), DS3231_FORMAT_AT(s, 18), DS3231_FORMAT_AT(s, 19), \
+    DS3231_FORMAT_AT(s, 20), DS3231_FORMAT_AT(s, 21), DS3231_FORMAT_AT(s, 22), DS3231_FORMAT_AT(s, 23), \
+    DS3231_FORMAT_AT(s, 24), DS3231_FORMAT_AT(s, 25), DS3231_FORMAT_AT(s, 26), DS3231_FORMAT_AT(s, 27), \
+    DS3231_FORMAT_AT(s, 28), DS3231_FORMAT_AT(s, 29), DS3231_FORMAT_AT(s, 30), DS3231_FORMAT_AT(s, 31)
+
+#define DS3231_FORMAT(s) DS3231FormatChecked<sizeof(s) - 1, \
+    DS3231FormatBuilder<DS3231Format<>, DS3231_FORMAT_CHARS(s)>::type>::type
+
+#endif
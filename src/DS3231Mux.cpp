@@ -0,0 +1,127 @@
+/*
+
+The MIT License
+
+Copyright (c) 2014-2023 Korneliusz Jarzębski
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "DS3231Mux.h"
+
+DS3231Mux::DS3231Mux(DS3231Bus &bus, uint8_t address)
+{
+    this->bus = &bus;
+    this->address = address;
+    selected = DS3231_MUX_UNKNOWN;
+    switches = 0;
+}
+
+bool DS3231Mux::select(uint8_t channel)
+{
+    if (channel >= DS3231_MUX_CHANNELS)
+    {
+        return false;
+    }
+
+    if (selected == channel)
+    {
+        return true;
+    }
+
+    if (!writeMask(1 << channel))
+    {
+        return false;
+    }
+
+    selected = channel;
+
+    return true;
+}
+
+bool DS3231Mux::disable(void)
+{
+    selected = DS3231_MUX_UNKNOWN;
+
+    return writeMask(0);
+}
+
+void DS3231Mux::invalidate(void)
+{
+    selected = DS3231_MUX_UNKNOWN;
+}
+
+// DS3231_MUX_UNKNOWN after disable(), invalidate() or a failed switch
+uint8_t DS3231Mux::getSelected(void)
+{
+    return selected;
+}
+
+uint32_t DS3231Mux::getSwitches(void)
+{
+    return switches;
+}
+
+// Transfers on the selected channel
+bool DS3231Mux::readRegisters(uint8_t address, uint8_t reg, uint8_t *values, uint8_t count)
+{
+    return bus->readRegisters(address, reg, values, count);
+}
+
+bool DS3231Mux::writeRegisters(uint8_t address, uint8_t reg, const uint8_t *values, uint8_t count)
+{
+    return bus->writeRegisters(address, reg, values, count);
+}
+
+// The TCA9548A has a single control register written without a register
+// address, so the mask goes out as the register byte of an empty write.
+bool DS3231Mux::writeMask(uint8_t mask)
+{
+    switches++;
+
+    if (!bus->writeRegisters(address, mask, &mask, 0))
+    {
+        selected = DS3231_MUX_UNKNOWN;
+        return false;
+    }
+
+    return true;
+}
+
+DS3231MuxChannel::DS3231MuxChannel(DS3231Mux &mux, uint8_t channel)
+{
+    this->mux = &mux;
+    this->channel = channel;
+}
+
+bool DS3231MuxChannel::readRegisters(uint8_t address, uint8_t reg, uint8_t *values, uint8_t count)
+{
+    return mux->select(channel) && mux->readRegisters(address, reg, values, count);
+}
+
+bool DS3231MuxChannel::writeRegisters(uint8_t address, uint8_t reg, const uint8_t *values, uint8_t count)
+{
+    return mux->select(channel) && mux->writeRegisters(address, reg, values, count);
+}
+
+uint8_t DS3231MuxChannel::getChannel(void)
+{
+    return channel;
+}
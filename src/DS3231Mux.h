@@ -0,0 +1,99 @@
+/*
+
+The MIT License
+
+Copyright (c) 2014-2023 Korneliusz Jarzębski
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+/*
+
+DS3231 behind a TCA9548A I2C multiplexer.
+
+Every DS3231 answers at 0x68, so several of them need a channel each.
+DS3231Mux wraps the upstream bus and remembers the selected channel; a
+DS3231MuxChannel is the bus of one channel and selects it before each
+transfer, skipping the write to the multiplexer when it is already
+selected:
+
+    DS3231TwoWire wireBus(Wire);
+    DS3231Mux mux(wireBus);
+    DS3231MuxChannel channel0(mux, 0);
+    DS3231MuxChannel channel1(mux, 1);
+
+    clock0.begin(channel0);
+    clock1.begin(channel1);
+
+Call invalidate() when other code changes the multiplexer behind its back.
+
+*/
+
+#ifndef DS3231Mux_h
+#define DS3231Mux_h
+
+#include "DS3231.h"
+
+#define DS3231_MUX_ADDRESS          (0x70)
+#define DS3231_MUX_CHANNELS         (8)
+#define DS3231_MUX_UNKNOWN          (0xFF)
+
+class DS3231Mux
+{
+    public:
+
+	DS3231Mux(DS3231Bus &bus, uint8_t address = DS3231_MUX_ADDRESS);
+
+	bool select(uint8_t channel);
+	bool disable(void);
+	void invalidate(void);
+
+	uint8_t getSelected(void);
+	uint32_t getSwitches(void);
+
+	bool readRegisters(uint8_t address, uint8_t reg, uint8_t *values, uint8_t count);
+	bool writeRegisters(uint8_t address, uint8_t reg, const uint8_t *values, uint8_t count);
+
+    private:
+	DS3231Bus *bus;
+	uint8_t address;
+	uint8_t selected;
+	uint32_t switches;
+
+	bool writeMask(uint8_t mask);
+};
+
+class DS3231MuxChannel : public DS3231Bus
+{
+    public:
+
+	DS3231MuxChannel(DS3231Mux &mux, uint8_t channel);
+
+	virtual bool readRegisters(uint8_t address, uint8_t reg, uint8_t *values, uint8_t count);
+	virtual bool writeRegisters(uint8_t address, uint8_t reg, const uint8_t *values, uint8_t count);
+
+	uint8_t getChannel(void);
+
+    private:
+	DS3231Mux *mux;
+	uint8_t channel;
+};
+
+#endif
@@ -0,0 +1,263 @@
+/*
+
+The MIT License
+
+Copyright (c) 2014-2023 Korneliusz Jarzębski
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "DS3231TemperatureLog.h"
+
+DS3231TemperatureLog::DS3231TemperatureLog(DS3231 &rtc, uint8_t *buffer, uint16_t size, uint16_t window)
+{
+    this->rtc = &rtc;
+    this->buffer = buffer;
+    this->window = window ? window : 1;
+
+    capacity = (size < 32768) ? size * 2 : 65534;
+
+    clear();
+}
+
+// Reads a new sample once per conversion period, returns true if it did
+bool DS3231TemperatureLog::update(void)
+{
+    if (count && ((millis() - lastRead) < DS3231_TEMPERATURE_INTERVAL))
+    {
+        return false;
+    }
+
+    lastRead = millis();
+
+    add(rtc->readTemperatureQuarters());
+
+    return true;
+}
+
+void DS3231TemperatureLog::add(int16_t quarters)
+{
+    uint16_t zigzag;
+    uint16_t value;
+    uint8_t nibbles = 1;
+
+    current.min = (current.count && current.min < quarters) ? current.min : quarters;
+    current.max = (current.count && current.max > quarters) ? current.max : quarters;
+    current.sum += quarters;
+
+    if (++current.count == window)
+    {
+        last = current;
+        resetStats(current);
+    }
+
+    // The oldest value is kept as is, the ring only holds differences
+    if (!count)
+    {
+        oldest = quarters;
+        latest = quarters;
+        count = 1;
+        return;
+    }
+
+    zigzag = ((uint16_t)(quarters - latest) << 1) ^ (uint16_t)((int16_t)(quarters - latest) >> 15);
+
+    for (value = zigzag; value >= 8; value >>= 3)
+    {
+        ++nibbles;
+    }
+
+    while (used && ((capacity - used) < nibbles))
+    {
+        evict();
+    }
+
+    // Too small a buffer for even one difference
+    if (capacity < nibbles)
+    {
+        oldest = quarters;
+        latest = quarters;
+        count = 1;
+        return;
+    }
+
+    for (value = zigzag; value >= 8; value >>= 3)
+    {
+        put(head, 0b1000 | (value & 0b0111));
+        head = (head + 1) % capacity;
+    }
+
+    put(head, value);
+    head = (head + 1) % capacity;
+
+    used += nibbles;
+    latest = quarters;
+    ++count;
+}
+
+void DS3231TemperatureLog::clear(void)
+{
+    head = 0;
+    tail = 0;
+    used = 0;
+    count = 0;
+    oldest = 0;
+    latest = 0;
+    lastRead = 0;
+
+    resetStats(current);
+    resetStats(last);
+
+    rewind();
+}
+
+uint16_t DS3231TemperatureLog::getCount(void)
+{
+    return count;
+}
+
+int16_t DS3231TemperatureLog::getLatest(void)
+{
+    return latest;
+}
+
+// Bytes of the buffer in use
+uint16_t DS3231TemperatureLog::getUsed(void)
+{
+    return (used + 1) / 2;
+}
+
+// Starts reading the history from the oldest sample
+void DS3231TemperatureLog::rewind(void)
+{
+    cursor = tail;
+    cursorCount = 0;
+    cursorValue = oldest;
+}
+
+bool DS3231TemperatureLog::next(int16_t &quarters)
+{
+    uint16_t nibbles;
+
+    if (cursorCount >= count)
+    {
+        return false;
+    }
+
+    if (cursorCount)
+    {
+        cursorValue += decode(cursor, nibbles);
+    }
+
+    ++cursorCount;
+
+    quarters = cursorValue;
+
+    return true;
+}
+
+DS3231TemperatureStats DS3231TemperatureLog::getWindow(void)
+{
+    return current;
+}
+
+DS3231TemperatureStats DS3231TemperatureLog::getLastWindow(void)
+{
+    return last;
+}
+
+// Mean in quarter degrees, rounded to nearest
+int16_t DS3231TemperatureLog::getMean(const DS3231TemperatureStats &stats)
+{
+    if (!stats.count)
+    {
+        return 0;
+    }
+
+    if (stats.sum < 0)
+    {
+        return (stats.sum - stats.count / 2) / stats.count;
+    }
+
+    return (stats.sum + stats.count / 2) / stats.count;
+}
+
+void DS3231TemperatureLog::put(uint16_t position, uint8_t nibble)
+{
+    uint8_t &value = buffer[position >> 1];
+
+    if (position & 1)
+    {
+        value = (value & 0x0F) | (nibble << 4);
+    } else
+    {
+        value = (value & 0xF0) | nibble;
+    }
+}
+
+uint8_t DS3231TemperatureLog::get(uint16_t position)
+{
+    uint8_t value = buffer[position >> 1];
+
+    return (position & 1) ? (value >> 4) : (value & 0x0F);
+}
+
+int16_t DS3231TemperatureLog::decode(uint16_t &position, uint16_t &nibbles)
+{
+    uint16_t zigzag = 0;
+    uint8_t shift = 0;
+    uint8_t nibble;
+
+    nibbles = 0;
+
+    do
+    {
+        nibble = get(position);
+        position = (position + 1) % capacity;
+        ++nibbles;
+
+        zigzag |= (uint16_t)(nibble & 0b0111) << shift;
+        shift += 3;
+    } while (nibble & 0b1000);
+
+    return (int16_t)((zigzag >> 1) ^ -(zigzag & 1));
+}
+
+// Drops the oldest sample, the next one becomes the stored value
+void DS3231TemperatureLog::evict(void)
+{
+    uint16_t nibbles;
+
+    oldest += decode(tail, nibbles);
+
+    used -= nibbles;
+    --count;
+
+    // A running read may have pointed at the dropped sample
+    rewind();
+}
+
+void DS3231TemperatureLog::resetStats(DS3231TemperatureStats &stats)
+{
+    stats.min = 0;
+    stats.max = 0;
+    stats.sum = 0;
+    stats.count = 0;
+}
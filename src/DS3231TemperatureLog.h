@@ -0,0 +1,111 @@
+/*
+
+The MIT License
+
+Copyright (c) 2014-2023 Korneliusz Jarzębski
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+/*
+
+Temperature history in a compact RAM ring.
+
+update() reads the temperature only once per DS3231_TEMPERATURE_INTERVAL,
+the period of the chip's own conversions, so it can be called from every
+loop(). Readings are kept in quarter degrees as the difference to the
+previous one, zigzag encoded into 4-bit groups: three value bits and a
+continuation bit. A steady temperature costs a single nibble per sample,
+so a day of 64 second samples fits in about 700 bytes. When the buffer is
+full the oldest samples are dropped.
+
+Minimum, maximum and mean are kept for tumbling windows of a fixed number
+of samples. getWindow() is the window being filled, getLastWindow() the
+last complete one, both in constant time.
+
+*/
+
+#ifndef DS3231TemperatureLog_h
+#define DS3231TemperatureLog_h
+
+#include "DS3231.h"
+
+#define DS3231_TEMPERATURE_INTERVAL (64000)
+
+struct DS3231TemperatureStats
+{
+    int16_t min;
+    int16_t max;
+    int32_t sum;
+    uint16_t count;
+};
+
+class DS3231TemperatureLog
+{
+    public:
+
+	DS3231TemperatureLog(DS3231 &rtc, uint8_t *buffer, uint16_t size, uint16_t window = 56);
+
+	bool update(void);
+	void add(int16_t quarters);
+	void clear(void);
+
+	uint16_t getCount(void);
+	int16_t getLatest(void);
+	uint16_t getUsed(void);
+
+	void rewind(void);
+	bool next(int16_t &quarters);
+
+	DS3231TemperatureStats getWindow(void);
+	DS3231TemperatureStats getLastWindow(void);
+	static int16_t getMean(const DS3231TemperatureStats &stats);
+
+    private:
+	DS3231 *rtc;
+
+	uint8_t *buffer;
+	uint16_t capacity;
+	uint16_t head;
+	uint16_t tail;
+	uint16_t used;
+
+	uint16_t count;
+	int16_t oldest;
+	int16_t latest;
+	uint32_t lastRead;
+
+	uint16_t cursor;
+	uint16_t cursorCount;
+	int16_t cursorValue;
+
+	uint16_t window;
+	DS3231TemperatureStats current;
+	DS3231TemperatureStats last;
+
+	void put(uint16_t position, uint8_t nibble);
+	uint8_t get(uint16_t position);
+	int16_t decode(uint16_t &position, uint16_t &nibbles);
+	void evict(void);
+
+	static void resetStats(DS3231TemperatureStats &stats);
+};
+
+#endif
@@ -0,0 +1,281 @@
+/*
+
+The MIT License
+
+Copyright (c) 2014-2023 Korneliusz Jarzębski
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "DS3231Timers.h"
+
+DS3231Timer::DS3231Timer(void (*callback)(void *context), void *context)
+{
+    this->callback = callback;
+    this->context = context;
+
+    deadline = 0;
+    period = 0;
+    index = DS3231_TIMER_IDLE;
+}
+
+uint32_t DS3231Timer::getDeadline(void)
+{
+    return deadline;
+}
+
+uint32_t DS3231Timer::getPeriod(void)
+{
+    return period;
+}
+
+DS3231Timers::DS3231Timers(DS3231 &rtc, DS3231Timer **heap, uint8_t capacity)
+{
+    this->rtc = &rtc;
+    this->heap = heap;
+    this->capacity = (capacity < DS3231_TIMER_IDLE) ? capacity : DS3231_TIMER_IDLE - 1;
+
+    size = 0;
+    pending = false;
+    programmed = 0;
+    armed = false;
+}
+
+// Deadlines are unixtimes as returned by readDateTime(). A period of zero
+// makes a one-shot timer. Restarting an active timer moves it.
+bool DS3231Timers::start(DS3231Timer &timer, uint32_t deadline, uint32_t period)
+{
+    if (timer.index != DS3231_TIMER_IDLE)
+    {
+        remove(timer.index);
+    } else if (size == capacity)
+    {
+        return false;
+    }
+
+    timer.deadline = deadline;
+    timer.period = period;
+
+    insert(&timer);
+
+    program();
+
+    return true;
+}
+
+void DS3231Timers::stop(DS3231Timer &timer)
+{
+    if (timer.index == DS3231_TIMER_IDLE)
+    {
+        return;
+    }
+
+    remove(timer.index);
+
+    program();
+}
+
+bool DS3231Timers::isActive(DS3231Timer &timer)
+{
+    return timer.index != DS3231_TIMER_IDLE;
+}
+
+uint8_t DS3231Timers::count(void)
+{
+    return size;
+}
+
+DS3231Timer *DS3231Timers::next(void)
+{
+    return size ? heap[0] : 0;
+}
+
+void DS3231Timers::handleInterrupt(void)
+{
+    pending = true;
+}
+
+bool DS3231Timers::isPending(void)
+{
+    return pending;
+}
+
+// Fires every expired timer and returns how many fired. Periodic timers
+// that fell behind skip the missed periods instead of firing in a burst.
+uint8_t DS3231Timers::dispatch(void)
+{
+    uint8_t fired = 0;
+    uint32_t now;
+
+    pending = false;
+
+    now = rtc->readDateTime().unixtime;
+
+    // A raised alarm 1 flag means the programmed deadline was reached, even
+    // if the time read trails it. The alarm ignores the month, so a flag a
+    // day or more early is an earlier month with the same date; it is only
+    // acknowledged, and the unchanged alarm matches again a month on.
+    if ((rtc->pollAlarms(DS3231_ALARM_1) & DS3231_ALARM_1) && armed &&
+        ((int32_t)(programmed - now) > 0) && ((int32_t)(programmed - now) < 86400))
+    {
+        now = programmed;
+    }
+
+    while (size && ((int32_t)(heap[0]->deadline - now) <= 0))
+    {
+        DS3231Timer *timer = heap[0];
+
+        remove(0);
+
+        if (timer->period)
+        {
+            timer->deadline += ((now - timer->deadline) / timer->period + 1) * timer->period;
+
+            insert(timer);
+        }
+
+        // Called last, so the callback may restart or stop its own timer
+        timer->callback(timer->context);
+
+        ++fired;
+    }
+
+    program();
+
+    return fired;
+}
+
+void DS3231Timers::insert(DS3231Timer *timer)
+{
+    place(timer, size++);
+
+    siftUp(timer->index);
+}
+
+void DS3231Timers::remove(uint8_t index)
+{
+    DS3231Timer *last;
+
+    heap[index]->index = DS3231_TIMER_IDLE;
+
+    last = heap[--size];
+
+    if (index == size)
+    {
+        return;
+    }
+
+    place(last, index);
+
+    siftUp(index);
+    siftDown(last->index);
+}
+
+void DS3231Timers::siftUp(uint8_t index)
+{
+    DS3231Timer *timer = heap[index];
+
+    while (index > 0)
+    {
+        uint8_t parent = (index - 1) / 2;
+
+        if ((int32_t)(heap[parent]->deadline - timer->deadline) <= 0)
+        {
+            break;
+        }
+
+        place(heap[parent], index);
+
+        index = parent;
+    }
+
+    place(timer, index);
+}
+
+void DS3231Timers::siftDown(uint8_t index)
+{
+    DS3231Timer *timer = heap[index];
+
+    for (;;)
+    {
+        uint16_t child = 2 * index + 1;
+
+        if (child >= size)
+        {
+            break;
+        }
+
+        if ((child + 1 < size) && ((int32_t)(heap[child + 1]->deadline - heap[child]->deadline) < 0))
+        {
+            ++child;
+        }
+
+        if ((int32_t)(timer->deadline - heap[child]->deadline) <= 0)
+        {
+            break;
+        }
+
+        place(heap[child], index);
+
+        index = child;
+    }
+
+    place(timer, index);
+}
+
+void DS3231Timers::place(DS3231Timer *timer, uint8_t index)
+{
+    heap[index] = timer;
+    timer->index = index;
+}
+
+// Alarm 1 is only rewritten when the nearest deadline changes. A deadline
+// that already passed, newly written or not, would not match until next
+// month, so it is marked pending for the next dispatch() instead.
+void DS3231Timers::program(void)
+{
+    RTCDateTime dt;
+
+    if (!size)
+    {
+        if (armed)
+        {
+            rtc->armAlarm1(false);
+            armed = false;
+        }
+
+        return;
+    }
+
+    if (!armed || (heap[0]->deadline != programmed))
+    {
+        programmed = heap[0]->deadline;
+        armed = true;
+
+        dt = DS3231::loadDateTimeFromLong(programmed);
+
+        rtc->setAlarm1(dt.day, dt.hour, dt.minute, dt.second, DS3231_MATCH_DT_H_M_S);
+    }
+
+    if ((int32_t)(programmed - rtc->readDateTime().unixtime) <= 0)
+    {
+        pending = true;
+    }
+}
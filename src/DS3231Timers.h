@@ -0,0 +1,110 @@
+/*
+
+The MIT License
+
+Copyright (c) 2014-2023 Korneliusz Jarzębski
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+/*
+
+Any number of software timers multiplexed on alarm 1.
+
+Timers live in caller-owned storage and are kept in a binary min-heap of
+pointers, so the nearest deadline is always at the top. That deadline is
+programmed into alarm 1 as a date, hour, minute and second match, and is
+only rewritten when the top of the heap changes. The match ignores the
+month, so a deadline more than a month away also matches in earlier
+months; those early alarms are acknowledged without firing anything.
+Alarm 2 stays free.
+
+The alarm interrupt should only call handleInterrupt(). dispatch() then
+runs from loop(), because it talks to the chip: it acknowledges the alarm,
+fires every expired timer, re-queues periodic ones and arms the next
+deadline. INTCN must be set, e.g. with enableOutput(false).
+
+*/
+
+#ifndef DS3231Timers_h
+#define DS3231Timers_h
+
+#include "DS3231.h"
+
+#define DS3231_TIMER_IDLE           (0xFF)
+
+class DS3231Timer
+{
+    public:
+
+	DS3231Timer(void (*callback)(void *context), void *context = 0);
+
+	uint32_t getDeadline(void);
+	uint32_t getPeriod(void);
+
+    private:
+	friend class DS3231Timers;
+
+	void (*callback)(void *context);
+	void *context;
+
+	uint32_t deadline;
+	uint32_t period;
+	uint8_t index;
+};
+
+class DS3231Timers
+{
+    public:
+
+	DS3231Timers(DS3231 &rtc, DS3231Timer **heap, uint8_t capacity);
+
+	bool start(DS3231Timer &timer, uint32_t deadline, uint32_t period = 0);
+	void stop(DS3231Timer &timer);
+	bool isActive(DS3231Timer &timer);
+
+	uint8_t count(void);
+	DS3231Timer *next(void);
+
+	void handleInterrupt(void);
+	bool isPending(void);
+	uint8_t dispatch(void);
+
+    private:
+	DS3231 *rtc;
+
+	DS3231Timer **heap;
+	uint8_t capacity;
+	uint8_t size;
+
+	volatile bool pending;
+	uint32_t programmed;
+	bool armed;
+
+	void insert(DS3231Timer *timer);
+	void remove(uint8_t index);
+	void siftUp(uint8_t index);
+	void siftDown(uint8_t index);
+	void place(DS3231Timer *timer, uint8_t index);
+
+	void program(void);
+};
+
+#endif
@@ -0,0 +1,407 @@
+/*
+
+The MIT License
+
+Copyright (c) 2014-2023 Korneliusz Jarzębski
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "DS3231Timezone.h"
+
+DS3231Timezone::DS3231Timezone(void)
+{
+    parse("UTC0");
+}
+
+DS3231Timezone::DS3231Timezone(const char *tz)
+{
+    parse("UTC0");
+    parse(tz);
+}
+
+bool DS3231Timezone::parse(const char *tz)
+{
+    const char *p = tz;
+    char names[2][DS3231_TIMEZONE_NAME];
+    int32_t offsets[2];
+    DS3231TimezoneRule rules[2] = { { 'M', 3, 2, 0, 7200 }, { 'M', 11, 1, 0, 7200 } };
+    bool daylight = false;
+
+    if (!parseName(p, names[0]) || !parseTime(p, offsets[0], 24))
+    {
+        return false;
+    }
+
+    // POSIX offsets count west of UTC
+    offsets[0] = -offsets[0];
+    offsets[1] = offsets[0];
+    names[1][0] = '\0';
+
+    if (*p != '\0')
+    {
+        if (!parseName(p, names[1]))
+        {
+            return false;
+        }
+
+        daylight = true;
+        offsets[1] = offsets[0] + 3600;
+
+        if ((*p != ',') && (*p != '\0'))
+        {
+            if (!parseTime(p, offsets[1], 24))
+            {
+                return false;
+            }
+
+            offsets[1] = -offsets[1];
+        }
+
+        if (*p == ',')
+        {
+            ++p;
+
+            if (!parseRule(p, rules[0]) || (*p != ','))
+            {
+                return false;
+            }
+
+            ++p;
+
+            if (!parseRule(p, rules[1]))
+            {
+                return false;
+            }
+        }
+    }
+
+    if (*p != '\0')
+    {
+        return false;
+    }
+
+    memcpy(stdName, names[0], DS3231_TIMEZONE_NAME);
+    memcpy(dstName, names[1], DS3231_TIMEZONE_NAME);
+    stdOffset = offsets[0];
+    dstOffset = offsets[1];
+    hasDst = daylight;
+    start = rules[0];
+    end = rules[1];
+
+    // Empty interval, the next conversion fills the cache
+    from = 0;
+    until = 0;
+
+    return true;
+}
+
+uint32_t DS3231Timezone::toLocal(uint32_t utc)
+{
+    lookup(utc);
+
+    return utc + offset;
+}
+
+RTCDateTime DS3231Timezone::toLocal(const RTCDateTime &utc)
+{
+    return DS3231::loadDateTimeFromLong(toLocal(utc.unixtime));
+}
+
+// Local times skipped when daylight time starts are moved forward by the
+// gap, repeated ones when it ends resolve to the first occurrence.
+uint32_t DS3231Timezone::toUtc(uint32_t local)
+{
+    return local - getOffset(local - dstOffset);
+}
+
+RTCDateTime DS3231Timezone::toUtc(const RTCDateTime &local)
+{
+    return DS3231::loadDateTimeFromLong(toUtc(local.unixtime));
+}
+
+int32_t DS3231Timezone::getOffset(uint32_t utc)
+{
+    lookup(utc);
+
+    return offset;
+}
+
+bool DS3231Timezone::isDst(uint32_t utc)
+{
+    lookup(utc);
+
+    return dst;
+}
+
+const char *DS3231Timezone::getAbbreviation(uint32_t utc)
+{
+    lookup(utc);
+
+    return dst ? dstName : stdName;
+}
+
+// 0xFFFFFFFF without daylight time
+uint32_t DS3231Timezone::getNextTransition(uint32_t utc)
+{
+    lookup(utc);
+
+    return until;
+}
+
+void DS3231Timezone::lookup(uint32_t utc)
+{
+    // One unsigned compare covers both ends of [from, until)
+    if ((utc - from) >= (until - from))
+    {
+        update(utc);
+    }
+}
+
+void DS3231Timezone::update(uint32_t utc)
+{
+    uint16_t year = DS3231::loadDateTimeFromLong(utc).year;
+    int64_t last = -1;
+    int64_t next = 0x100000000LL;
+    bool nextDst = false;
+
+    dst = false;
+
+    if (hasDst)
+    {
+        // Transitions of the years around utc, start in standard time and
+        // end in daylight time
+        for (uint16_t y = year - 1; y <= year + 1; ++y)
+        {
+            if ((y < 2000) || (y > 2199))
+            {
+                continue;
+            }
+
+            for (uint8_t i = 0; i < 2; ++i)
+            {
+                bool on = (i == 0);
+                int64_t t = on ? (transition(start, y) - stdOffset) : (transition(end, y) - dstOffset);
+
+                if ((t <= (int64_t)utc) && (t > last))
+                {
+                    last = t;
+                    dst = on;
+                } else if ((t > (int64_t)utc) && (t < next))
+                {
+                    next = t;
+                    nextDst = on;
+                }
+            }
+        }
+
+        if (last < 0)
+        {
+            dst = !nextDst;
+        }
+    }
+
+    from = (last < 0) ? 0 : (uint32_t)last;
+    until = (next > 0xFFFFFFFFLL) ? 0xFFFFFFFF : (uint32_t)next;
+    offset = dst ? dstOffset : stdOffset;
+}
+
+// Local time of a transition in year, in seconds since 1970
+int64_t DS3231Timezone::transition(const DS3231TimezoneRule &rule, uint16_t year)
+{
+    uint32_t days;
+
+    if (rule.type == 'M')
+    {
+        uint8_t length = DS3231::daysInMonth(year, rule.month);
+        uint8_t day;
+
+        days = DS3231::date2days(year, rule.month, 1);
+
+        // 2000-01-01 was a Saturday, weekday 6
+        day = 1 + (rule.day + 7 - (days + 6) % 7) % 7 + (rule.week - 1) * 7;
+
+        while (day > length)
+        {
+            day -= 7;
+        }
+
+        days += day - 1;
+    } else
+    {
+        days = DS3231::date2days(year, 1, 1) + rule.day;
+
+        if ((rule.type == 'J') && (rule.day >= 59) && DS3231::isLeapYear(year))
+        {
+            ++days;
+        }
+    }
+
+    return (int64_t)days * 86400 + rule.time + DS3231_EPOCH;
+}
+
+bool DS3231Timezone::parseName(const char *&p, char *name)
+{
+    uint8_t length = 0;
+    bool quoted = (*p == '<');
+
+    if (quoted)
+    {
+        ++p;
+    }
+
+    while (quoted ? ((*p != '>') && (*p != '\0')) : (((*p >= 'A') && (*p <= 'Z')) || ((*p >= 'a') && (*p <= 'z'))))
+    {
+        if (length < DS3231_TIMEZONE_NAME - 1)
+        {
+            name[length] = *p;
+        }
+
+        ++length;
+        ++p;
+    }
+
+    if (quoted)
+    {
+        if (*p != '>')
+        {
+            return false;
+        }
+
+        ++p;
+    }
+
+    name[(length < DS3231_TIMEZONE_NAME - 1) ? length : (DS3231_TIMEZONE_NAME - 1)] = '\0';
+
+    return (length >= 3);
+}
+
+// [+-]hh[:mm[:ss]]
+bool DS3231Timezone::parseTime(const char *&p, int32_t &seconds, uint8_t maxHours)
+{
+    bool negative = (*p == '-');
+    uint16_t value;
+
+    if ((*p == '-') || (*p == '+'))
+    {
+        ++p;
+    }
+
+    if (!parseNumber(p, value, 0, maxHours))
+    {
+        return false;
+    }
+
+    seconds = (int32_t)value * 3600;
+
+    for (uint16_t scale = 60; (scale > 0) && (*p == ':'); scale /= 60)
+    {
+        ++p;
+
+        if (!parseNumber(p, value, 0, 59))
+        {
+            return false;
+        }
+
+        seconds += (int32_t)value * scale;
+    }
+
+    if (negative)
+    {
+        seconds = -seconds;
+    }
+
+    return true;
+}
+
+bool DS3231Timezone::parseRule(const char *&p, DS3231TimezoneRule &rule)
+{
+    uint16_t month;
+    uint16_t week;
+    uint16_t day;
+
+    rule.type = 'N';
+
+    if (*p == 'M')
+    {
+        ++p;
+
+        if (!parseNumber(p, month, 1, 12) || (*p++ != '.') ||
+            !parseNumber(p, week, 1, 5) || (*p++ != '.') ||
+            !parseNumber(p, day, 0, 6))
+        {
+            return false;
+        }
+
+        rule.type = 'M';
+        rule.month = month;
+        rule.week = week;
+    } else if (*p == 'J')
+    {
+        ++p;
+
+        if (!parseNumber(p, day, 1, 365))
+        {
+            return false;
+        }
+
+        rule.type = 'J';
+        --day;
+    } else if (!parseNumber(p, day, 0, 365))
+    {
+        return false;
+    }
+
+    rule.day = day;
+    rule.time = 7200;
+
+    if (*p == '/')
+    {
+        ++p;
+
+        return parseTime(p, rule.time, 167);
+    }
+
+    return true;
+}
+
+bool DS3231Timezone::parseNumber(const char *&p, uint16_t &value, uint16_t min, uint16_t max)
+{
+    if ((*p < '0') || (*p > '9'))
+    {
+        return false;
+    }
+
+    value = 0;
+
+    while ((*p >= '0') && (*p <= '9'))
+    {
+        value = value * 10 + (*p - '0');
+
+        if (value > max)
+        {
+            return false;
+        }
+
+        ++p;
+    }
+
+    return (value >= min);
+}
@@ -0,0 +1,106 @@
+/*
+
+The MIT License
+
+Copyright (c) 2014-2023 Korneliusz Jarzębski
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+/*
+
+Local time from a UTC clock, with POSIX TZ rules.
+
+parse() takes a TZ string such as "CET-1CEST,M3.5.0,M10.5.0/3" or
+"<+0530>-5:30". As in POSIX the offset counts hours west of UTC, so central
+Europe is -1. The daylight offset defaults to one hour ahead of standard
+time. Rules are Mmonth.week.weekday (week 5 being the last), Jday (1 to
+365, February 29th never counted) or day (0 to 365), each with an optional
+/time of day, 02:00 by default. A daylight name without rules follows the
+US rules, M3.2.0,M11.1.0.
+
+The interval between two transitions is cached together with its offset.
+Converting inside it is one compare and one add; the rules are only worked
+out again when a conversion falls outside it, about twice a year.
+
+*/
+
+#ifndef DS3231Timezone_h
+#define DS3231Timezone_h
+
+#include "DS3231.h"
+
+#define DS3231_TIMEZONE_NAME        (8)
+
+// type is 'M', 'J' or 'N' for a plain day number. With 'M' day is the
+// weekday, 0 for Sunday.
+struct DS3231TimezoneRule
+{
+    char type;
+    uint8_t month;
+    uint8_t week;
+    uint16_t day;
+    int32_t time;
+};
+
+class DS3231Timezone
+{
+    public:
+
+	DS3231Timezone(void);
+	DS3231Timezone(const char *tz);
+
+	bool parse(const char *tz);
+
+	uint32_t toLocal(uint32_t utc);
+	RTCDateTime toLocal(const RTCDateTime &utc);
+	uint32_t toUtc(uint32_t local);
+	RTCDateTime toUtc(const RTCDateTime &local);
+
+	int32_t getOffset(uint32_t utc);
+	bool isDst(uint32_t utc);
+	const char *getAbbreviation(uint32_t utc);
+	uint32_t getNextTransition(uint32_t utc);
+
+    private:
+	char stdName[DS3231_TIMEZONE_NAME];
+	char dstName[DS3231_TIMEZONE_NAME];
+	int32_t stdOffset;
+	int32_t dstOffset;
+	bool hasDst;
+	DS3231TimezoneRule start;
+	DS3231TimezoneRule end;
+
+	uint32_t from;
+	uint32_t until;
+	int32_t offset;
+	bool dst;
+
+	void lookup(uint32_t utc);
+	void update(uint32_t utc);
+	static int64_t transition(const DS3231TimezoneRule &rule, uint16_t year);
+
+	static bool parseName(const char *&p, char *name);
+	static bool parseTime(const char *&p, int32_t &seconds, uint8_t maxHours);
+	static bool parseRule(const char *&p, DS3231TimezoneRule &rule);
+	static bool parseNumber(const char *&p, uint16_t &value, uint16_t min, uint16_t max);
+};
+
+#endif